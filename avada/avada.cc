@@ -21,12 +21,15 @@
 #include "base/exception.hpp"
 #include "base/string_util.hpp"
 
+#include <algorithm>
+#include <array>
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <sstream>
 #include <sys/ioctl.h>
 #include <sys/poll.h>
+#include <sys/signalfd.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -40,15 +43,17 @@ namespace {
   if ((call) != 0)                 \
   throw ::base::system_exception(#call)
 
-volatile std::sig_atomic_t g_pending_resize = 0;
 Context* g_avada_context;
 
-extern "C" void handle_resize(int) {
-  g_pending_resize = 1;
-}
-
 }  // namespace
 
+void block_resize_signal() {
+  sigset_t sigwinch;
+  ::sigemptyset(&sigwinch);
+  ::sigaddset(&sigwinch, SIGWINCH);
+  SYSTEM_CALL_NON_ZERO(::pthread_sigmask(SIG_BLOCK, &sigwinch, nullptr));
+}
+
 Context::Context()
     : capabilities_{}
     , private_mode_changer_{
@@ -58,7 +63,7 @@ Context::Context()
               1006,  // Report Mouse Move.
               1003,  // Use All Motion Mouse Tracking.
               1049,  // Save cursor and use Alternate Screen Buffer, clearing it first.
-              2004,  // Set bracketed paste mode. TODO: support bracketed paste mode.
+              2004,  // Set bracketed paste mode.
           },
           {
               // Disable:
@@ -68,13 +73,21 @@ Context::Context()
               30,    // Don't show scrollbar.
               1010,  // Don’t scroll to bottom on tty output (rxvt).
               1011,  // Don’t scroll to bottom on key press (rxvt).
-          }} {
+          }}
+    , pending_events_begin_{0}
+    , loop_{nullptr} {
   ASSERT(g_avada_context == nullptr) << "Only one AvadaContext is permitted to exist";
 
   detect_capabilities();
 
-  if ((saved_sigwinch_ = std::signal(SIGWINCH, handle_resize)) == SIG_ERR) {
-    throw base::system_exception("signal(SIGWINCH, ...) failed");
+  // Receive SIGWINCH via the fd. It's already blocked in the other threads, see
+  // `block_resize_signal()`.
+  sigset_t sigwinch;
+  ::sigemptyset(&sigwinch);
+  ::sigaddset(&sigwinch, SIGWINCH);
+  SYSTEM_CALL_NON_ZERO(::pthread_sigmask(SIG_BLOCK, &sigwinch, &saved_sigmask_));
+  if ((signal_fd_ = ::signalfd(-1, &sigwinch, SFD_NONBLOCK | SFD_CLOEXEC)) == -1) {
+    throw base::system_exception("signalfd(SIGWINCH) failed");
   }
 
   std::setlocale(LC_ALL, "");
@@ -100,67 +113,139 @@ Context::Context()
       "\x1b%G"  // UTF-8
       "\x1b=");
 
-  update_size();
+  // Push kitty keyboard protocol flags: disambiguate keys and report event types.
+  // Terminals, not supporting the protocol, ignore it.
+  internal::write_stdout("\x1b[>3u");
+
+  const auto size = query_size();
+  resize(size.columns, size.rows);
 
   // Must be the last line.
   g_avada_context = this;
 }
 
 Context::~Context() noexcept {
-  std::signal(SIGWINCH, saved_sigwinch_);
+  // Pop kitty keyboard protocol flags.
+  internal::write_stdout("\x1b[<u");
+  ::close(signal_fd_);
+  ::pthread_sigmask(SIG_SETMASK, &saved_sigmask_, nullptr);
   ::tcsetattr(STDIN_FILENO, TCSAFLUSH, saved_context_.get());
   ASSERT(g_avada_context == this);
   g_avada_context = nullptr;
 }
 
-input::Event Context::poll_event(std::chrono::milliseconds timeout) {
-  pollfd pfd{STDIN_FILENO, POLLIN, 0};
+void Context::poll_events(std::chrono::milliseconds timeout) {
+  // Don't read more until the events from the previous read are queued, the kernel
+  // buffers the input meanwhile.
+  if (!flush_events())
+    return;
 
-  int poll_result = ::poll(&pfd, 1, timeout.count() /*ms*/);
-  if (poll_result == 0) {
-    if (g_pending_resize) {
-      // Doesn't necessarily interrupt the poll, because we may be not
-      //  on the main thread.
-      g_pending_resize = 0;
-      update_size();
-      return input::ResizeEvent{columns_, rows_};
-    }
-    return input::ServiceEvent::IDLE;
-  }
-  if (poll_result == -1) {
-    if (errno == EINTR && g_pending_resize) {
-      // We've caught SIGWINCH, it's ok.
-      g_pending_resize = 0;
-      update_size();
-      return input::ResizeEvent{columns_, rows_};
-    }
-    // Otherwise it's not ok.
+  // Don't sleep past the escape timeout, if there is pending incomplete input.
+  if (auto pending_timeout = input_parser_.pending_timeout()) {
+    timeout = std::min(timeout, *pending_timeout);
+  }
+
+  pollfd pfds[] = {{STDIN_FILENO, POLLIN, 0}, {signal_fd_, POLLIN, 0}};
+  int poll_result = ::poll(pfds, std::size(pfds), timeout.count() /*ms*/);
+  if (poll_result == -1 && errno != EINTR) {
     throw base::system_exception("'poll' operation failed");
   }
 
-  // Now data is ready, read it.
-  std::array<char, 128> raw_data;
+  if (poll_result > 0 && (pfds[1].revents & POLLIN)) {
+    read_resize();
+  }
+  if (poll_result > 0 && (pfds[0].revents & POLLIN)) {
+    read_input();
+  } else {
+    input_parser_.flush_expired(pending_events_);
+  }
+  flush_events();
+}
+
+std::optional<input::Event> Context::next_event() {
+  auto event = events_.try_pop();
+  if (event) {
+    if (auto* resize_event = std::get_if<input::ResizeEvent>(&*event)) {
+      resize(resize_event->columns, resize_event->rows);
+    }
+  }
+  return event;
+}
+
+void Context::watch(base::RunLoop& loop, std::function<void()> on_events) {
+  loop_ = &loop;
+  on_events_ = std::move(on_events);
+  input_watch_ = loop.watch_fd(STDIN_FILENO, [this]() {
+    read_input();
+    dispatch_events();
+  });
+  resize_watch_ = loop.watch_fd(signal_fd_, [this]() {
+    read_resize();
+    dispatch_events();
+  });
+}
+
+void Context::dispatch_events() {
+  // Let the consumer make room in the queue until all the events are in.
+  for (bool flushed = false; !flushed;) {
+    flushed = flush_events();
+    on_events_();
+  }
+
+  escape_timeout_ = nullptr;
+  if (auto pending_timeout = input_parser_.pending_timeout()) {
+    escape_timeout_ = loop_->post_delayed([this]() {
+      input_parser_.flush_expired(pending_events_);
+      dispatch_events();
+    }, *pending_timeout, base::RunLoop::Priority::INPUT);
+  }
+}
+
+void Context::read_input() {
+  // Now data is ready, read it. The buffer is large enough for a burst of events
+  // (fast typing, mouse motion) to be read at once.
+  std::array<char, kReadBufferSize> raw_data;
   ssize_t n_read = 0;
   while (n_read <= 0) {
-    n_read = ::read(STDIN_FILENO, &raw_data, sizeof(raw_data));
+    n_read = ::read(STDIN_FILENO, raw_data.data(), raw_data.size());
     if (n_read == -1)
       throw base::system_exception("'read' operation failed");
   }
 
-  std::string_view data{raw_data.data(), static_cast<size_t>(n_read)};
+  input_parser_.parse({raw_data.data(), static_cast<size_t>(n_read)}, pending_events_);
+}
+
+void Context::read_resize() {
+  // Several signals may be coalesced, the size is queried once anyway.
+  signalfd_siginfo info;
+  while (::read(signal_fd_, &info, sizeof(info)) == sizeof(info)) {
+  }
+  pending_events_.push_back(query_size());
+}
 
-  return input_parser_.parse_event(data);
+bool Context::flush_events() noexcept {
+  for (; pending_events_begin_ < pending_events_.size(); ++pending_events_begin_) {
+    if (!events_.try_push(std::move(pending_events_[pending_events_begin_])))
+      return false;
+  }
+  pending_events_.clear();
+  pending_events_begin_ = 0;
+  return true;
 }
 
-void Context::render() {
-  render::render(back_buffer_, front_buffer_, capabilities_);
+bool Context::render(const render::RenderOptions& options) {
+  return render::render(back_buffer_, front_buffer_, capabilities_, options);
 }
 
-void Context::update_size() {
+input::ResizeEvent Context::query_size() const {
   struct winsize ws;
   SYSTEM_CALL_NON_ZERO(::ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws));
-  rows_ = ws.ws_row;
-  columns_ = ws.ws_col;
+  return {ws.ws_col, ws.ws_row};
+}
+
+void Context::resize(int columns, int rows) {
+  rows_ = rows;
+  columns_ = columns;
   back_buffer_ = render::Buffer(rows_, columns_);
 }
 
@@ -197,7 +282,7 @@ Context::ScopedPrivateModeChange::ScopedPrivateModeChange(
   format_control_sequence(oss, to_enable_, 'h');
   format_control_sequence(oss, to_disable_, 'l');
   auto sequence = oss.str();
-  LOG() << "Change mode sequence: " << internal::escape_for_log(sequence);
+  LOG(RENDER, INFO) << "Change mode sequence: " << internal::escape_for_log(sequence);
   internal::write_stdout(sequence);
 }
 
@@ -207,7 +292,7 @@ Context::ScopedPrivateModeChange::~ScopedPrivateModeChange() noexcept {
   format_control_sequence(oss, to_enable_, 'l');
   format_control_sequence(oss, to_disable_, 'h');
   auto sequence = oss.str();
-  LOG() << "Restore mode sequence: " << internal::escape_for_log(sequence);
+  LOG(RENDER, INFO) << "Restore mode sequence: " << internal::escape_for_log(sequence);
   internal::write_stdout(sequence);
 }
 
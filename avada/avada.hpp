@@ -20,12 +20,17 @@
 #include "avada/render.hpp"
 #include "base/exception.hpp"
 #include "base/macro.hpp"
+#include "base/run_loop.hpp"
+#include "base/spsc_ring.hpp"
 
 #include "avada/config.hpp"
 
 #include <signal.h>
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <vector>
 
 struct termios;
 
@@ -37,6 +42,13 @@ class AVADA_PUBLIC unsupported_exception : public base::exception {
   unsupported_exception(Args&&... args) : exception(std::forward<Args>(args)...) {}
 };
 
+// Blocks SIGWINCH for the calling thread and every thread started by it afterwards.
+// Must be called first thing in `main()`, before any thread is started: a thread with
+// the signal unblocked may receive it, and then the resize is lost.
+AVADA_PUBLIC void block_resize_signal() /* may throw */;
+
+// Reads resizes from a signalfd, so SIGWINCH must be blocked in every thread of the
+// process, see `block_resize_signal()`.
 class AVADA_PUBLIC Context {
  public:
   enum ColorSupport {
@@ -50,9 +62,26 @@ class AVADA_PUBLIC Context {
 
   DISABLE_COPY_MOVE(Context);
 
-  input::Event poll_event(std::chrono::milliseconds timeout) /* may throw */;
+  // Input is decoded on the producer side and consumed on the consumer side through a
+  // lock-free ring, so the two may run on different threads, e.g. a dedicated input
+  // thread and the UI thread. The rest of the context belongs to the consumer side.
+
+  // Producer side: waits up to `timeout` for input and queues all the events it
+  // carries. Doesn't read more input while the queue is full.
+  void poll_events(std::chrono::milliseconds timeout) /* may throw */;
+
+  // Consumer side: returns the next queued event, if any. Resize events take effect on
+  // the render buffer once consumed.
+  std::optional<input::Event> next_event();
 
-  void render() /* may throw */;
+  // Instead of polling, watches the input and resizes on the `loop`. `on_events` is
+  // called right from the watch, or the escape timeout, whenever there are events to
+  // consume. Both sides run on the loop's thread.
+  void watch(base::RunLoop& loop, std::function<void()> on_events) /* may throw */;
+
+  // Returns `false` if some damage was carried over to the next frame due to the
+  // budget, see `render::RenderOptions`.
+  bool render(const render::RenderOptions& options = {}) /* may throw */;
 
   GETTER int get_rows() const noexcept { return rows_; }
   GETTER int get_columns() const noexcept { return columns_; }
@@ -65,9 +94,17 @@ class AVADA_PUBLIC Context {
   GETTER const render::Buffer& render_buffer() const noexcept { return back_buffer_; }
 
  private:
-  AVADA_PRIVATE void update_size() /* may throw */;
+  AVADA_PRIVATE input::ResizeEvent query_size() const /* may throw */;
+  AVADA_PRIVATE void resize(int columns, int rows);
+  AVADA_PRIVATE bool flush_events() noexcept;
+  AVADA_PRIVATE void read_input() /* may throw */;
+  AVADA_PRIVATE void read_resize() /* may throw */;
+  AVADA_PRIVATE void dispatch_events();
   AVADA_PRIVATE void detect_capabilities();
 
+  static constexpr std::size_t kReadBufferSize = 4096;
+  static constexpr std::size_t kEventQueueSize = 256;
+
   class AVADA_PRIVATE ScopedPrivateModeChange {
    public:
     ScopedPrivateModeChange(std::initializer_list<int> to_enable,
@@ -88,13 +125,28 @@ class AVADA_PUBLIC Context {
   };
 
  private:
-  sighandler_t saved_sigwinch_;
+  // SIGWINCH is blocked and read from the `signal_fd_` instead.
+  sigset_t saved_sigmask_;
+  int signal_fd_;
   std::unique_ptr<termios> saved_context_;
   ColorSupport color_support_;
   render::TerminalCapabilities capabilities_;
   ScopedPrivateModeChange private_mode_changer_;
 
+  // Producer side:
   input::InputParser input_parser_;
+  // Decoded events, which are not queued yet, starting with `pending_events_begin_`.
+  std::vector<input::Event> pending_events_;
+  std::size_t pending_events_begin_;
+
+  base::SpscRing<input::Event, kEventQueueSize> events_;
+
+  // Watching mode:
+  base::RunLoop* loop_;
+  std::function<void()> on_events_;
+  base::ref_ptr<base::RunLoop::FdWatch> input_watch_;
+  base::ref_ptr<base::RunLoop::FdWatch> resize_watch_;
+  base::ref_ptr<base::RunLoop::DelayedTask> escape_timeout_;
 
   render::Buffer front_buffer_;
   render::Buffer back_buffer_;
@@ -24,9 +24,58 @@
 
 namespace avada::render {
 
+namespace {
+
+struct GlyphRange {
+  wchar_t first, last;
+};
+
+// East Asian Wide (W) and Fullwidth (F) ranges, sorted.
+constexpr GlyphRange kWideGlyphs[] = {
+    // clang-format off
+    {0x1100, 0x115F}, {0x231A, 0x231B}, {0x2329, 0x232A}, {0x23E9, 0x23EC},
+    {0x23F0, 0x23F0}, {0x23F3, 0x23F3}, {0x25FD, 0x25FE}, {0x2614, 0x2615},
+    {0x2648, 0x2653}, {0x267F, 0x267F}, {0x2693, 0x2693}, {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB}, {0x26BD, 0x26BE}, {0x26C4, 0x26C5}, {0x26CE, 0x26CE},
+    {0x26D4, 0x26D4}, {0x26EA, 0x26EA}, {0x26F2, 0x26F3}, {0x26F5, 0x26F5},
+    {0x26FA, 0x26FA}, {0x26FD, 0x26FD}, {0x2705, 0x2705}, {0x270A, 0x270B},
+    {0x2728, 0x2728}, {0x274C, 0x274C}, {0x274E, 0x274E}, {0x2753, 0x2755},
+    {0x2757, 0x2757}, {0x2795, 0x2797}, {0x27B0, 0x27B0}, {0x27BF, 0x27BF},
+    {0x2B1B, 0x2B1C}, {0x2B50, 0x2B50}, {0x2B55, 0x2B55}, {0x2E80, 0x303E},
+    {0x3041, 0x33FF}, {0x3400, 0x4DBF}, {0x4E00, 0x9FFF}, {0xA000, 0xA4CF},
+    {0xA960, 0xA97F}, {0xAC00, 0xD7A3}, {0xF900, 0xFAFF}, {0xFE10, 0xFE19},
+    {0xFE30, 0xFE6F}, {0xFF00, 0xFF60}, {0xFFE0, 0xFFE6}, {0x16FE0, 0x16FE4},
+    {0x17000, 0x18CFF}, {0x1B000, 0x1B2FF}, {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF},
+    {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F202}, {0x1F210, 0x1F23B},
+    {0x1F240, 0x1F248}, {0x1F250, 0x1F251}, {0x1F260, 0x1F265}, {0x1F300, 0x1F320},
+    {0x1F32D, 0x1F335}, {0x1F337, 0x1F37C}, {0x1F37E, 0x1F393}, {0x1F3A0, 0x1F3CA},
+    {0x1F3CF, 0x1F3D3}, {0x1F3E0, 0x1F3F0}, {0x1F3F4, 0x1F3F4}, {0x1F3F8, 0x1F43E},
+    {0x1F440, 0x1F440}, {0x1F442, 0x1F4FC}, {0x1F4FF, 0x1F53D}, {0x1F54B, 0x1F54E},
+    {0x1F550, 0x1F567}, {0x1F57A, 0x1F57A}, {0x1F595, 0x1F596}, {0x1F5A4, 0x1F5A4},
+    {0x1F5FB, 0x1F64F}, {0x1F680, 0x1F6C5}, {0x1F6CC, 0x1F6CC}, {0x1F6D0, 0x1F6D2},
+    {0x1F6D5, 0x1F6D7}, {0x1F6DC, 0x1F6DF}, {0x1F6EB, 0x1F6EC}, {0x1F6F4, 0x1F6FC},
+    {0x1F7E0, 0x1F7EB}, {0x1F7F0, 0x1F7F0}, {0x1F90C, 0x1F93A}, {0x1F93C, 0x1F945},
+    {0x1F947, 0x1F9FF}, {0x1FA70, 0x1FA7C}, {0x1FA80, 0x1FA88}, {0x1FA90, 0x1FABD},
+    {0x1FABF, 0x1FAC5}, {0x1FACE, 0x1FADB}, {0x1FAE0, 0x1FAE8}, {0x1FAF0, 0x1FAF8},
+    {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+    // clang-format on
+};
+
+}  // namespace
+
+int glyph_width(wchar_t wch) noexcept {
+  if (wch < kWideGlyphs[0].first)
+    return 1;
+  auto range = std::upper_bound(
+      std::begin(kWideGlyphs), std::end(kWideGlyphs), wch,
+      [](wchar_t wch, const GlyphRange& range) { return wch < range.first; });
+  return (--range)->last >= wch ? 2 : 1;
+}
+
 Buffer::Cell::Cell() noexcept
     : data_{0},
       data_len_{0},
+      width_{1},
       fg_color_{SystemColor::DEFAULT},
       bg_color_{SystemColor::DEFAULT},
       attributes_(0x0),
@@ -35,7 +84,10 @@ Buffer::Cell::Cell() noexcept
 bool Buffer::Cell::operator==(const Buffer::Cell& rhs) const noexcept {
   // dirty flag is ignored here.
 
-  if (data_len_ != rhs.data_len_)
+  if (data_len_ != rhs.data_len_ || data_len_ == kUnknownDataLen)
+    return false;
+
+  if (width_ != rhs.width_)
     return false;
 
   if (data_len_ == 0) {
@@ -53,11 +105,12 @@ bool Buffer::Cell::operator==(const Buffer::Cell& rhs) const noexcept {
 }
 
 void Buffer::Cell::set_data(char ch) noexcept {
-  if (data_len_ == 1 && data_[0] == ch) {
+  if (data_len_ == 1 && data_[0] == ch && width_ == 1) {
     return;
   }
   data_[0] = ch;
   data_len_ = 1;
+  width_ = 1;
   dirty_ = true;
 }
 
@@ -67,13 +120,23 @@ void Buffer::Cell::set_data(wchar_t wch) noexcept {
   auto chars = utf8_cvt_.to_bytes(wch);
   const auto new_size = chars.size();
   ASSERT(new_size <= data_.size());
+  const auto new_width = glyph_width(wch);
 
-  if (new_size == data_len_ &&
+  if (new_size == data_len_ && new_width == width_ &&
       std::equal(std::begin(data_), std::begin(data_) + data_len_, std::begin(chars)))
     return;
 
   std::copy(std::begin(chars), std::end(chars), std::begin(data_));
   data_len_ = new_size;
+  width_ = new_width;
+  dirty_ = true;
+}
+
+void Buffer::Cell::set_continuation() noexcept {
+  if (width_ == 0)
+    return;
+  data_len_ = 0;
+  width_ = 0;
   dirty_ = true;
 }
 
@@ -100,9 +163,10 @@ void Buffer::Cell::set_attributes(uint8_t attributes) noexcept {
 
 void Buffer::Cell::blend(const Buffer::Cell& rhs) noexcept {
   // Copy data as is.
-  bool changed = data() != rhs.data();
+  bool changed = data() != rhs.data() || width_ != rhs.width_;
   data_ = rhs.data_;
   data_len_ = rhs.data_len_;
+  width_ = rhs.width_;
 
   // Blend colors.
   changed |= fg_color_ != (fg_color_ = alpha_blend(rhs.fg_color(), fg_color_));
@@ -136,6 +200,17 @@ void Buffer::clear() noexcept {
   }
 }
 
+void Buffer::split_glyph(int i, int j) noexcept {
+  auto& cell = (*this)(i, j);
+  if (cell.continuation() && j > 0) {
+    // Right half is overwritten, blank the left one.
+    (*this)(i, j - 1).set_data(' ');
+  } else if (cell.width() == 2 && j + 1 < columns_) {
+    // Left half is overwritten, blank the right one.
+    (*this)(i, j + 1).set_data(' ');
+  }
+}
+
 Buffer::Cell& Buffer::operator()(int i, int j) noexcept {
   ASSERT(i >= 0 && i <= rows_) << "i: " << i;
   ASSERT(j >= 0 && j <= columns_) << "j:" << j;
@@ -28,6 +28,14 @@
 namespace avada::render {
 
 struct TerminalCapabilities;
+struct RenderOptions;
+
+// Returns the number of terminal columns taken by the glyph: 2 for East Asian Wide and
+// Fullwidth characters (CJK, most emoji), 1 otherwise.
+AVADA_PUBLIC int glyph_width(wchar_t wch) noexcept;
+inline int glyph_width(char) noexcept {
+  return 1;
+}
 
 class AVADA_PUBLIC Buffer {
  public:
@@ -39,6 +47,10 @@ class AVADA_PUBLIC Buffer {
 
   void clear() noexcept;
 
+  // Replaces the halves of a wide glyph overlapping the (i, j) cell with blanks.
+  // Must be called before the cell is overwritten, so no broken glyphs remain.
+  void split_glyph(int i, int j) noexcept;
+
   class Cell {
    public:
     Cell() noexcept;
@@ -53,8 +65,14 @@ class AVADA_PUBLIC Buffer {
     GETTER uint8_t attributes() const noexcept { return attributes_; }
     GETTER bool dirty() const noexcept { return dirty_; }
 
+    // Number of columns taken by the glyph, `0` for continuation cells.
+    GETTER int width() const noexcept { return width_; }
+    // The cell is covered by a wide glyph from the cell to the left.
+    GETTER bool continuation() const noexcept { return width_ == 0; }
+
     void set_data(char ch) noexcept;
     void set_data(wchar_t wch) noexcept;
+    void set_continuation() noexcept;
     void set_fg_color(Color fg) noexcept;
     void set_bg_color(Color bg) noexcept;
     void set_attributes(uint8_t attributes) noexcept;
@@ -65,9 +83,16 @@ class AVADA_PUBLIC Buffer {
     void mark_dirty() noexcept { dirty_ = true; }
     void clear_dirty() noexcept { dirty_ = false; }
 
+    // Makes the cell unequal to any other one. Used for screen reference cells, whose
+    // actual contents on the screen are not known.
+    void mark_unknown() noexcept { data_len_ = kUnknownDataLen; }
+
    private:
+    static constexpr uint8_t kUnknownDataLen = 0xFF;
+
     std::array<char, sizeof(wchar_t)> data_;
     uint8_t data_len_;
+    uint8_t width_;
     Color fg_color_;
     Color bg_color_;
     uint8_t attributes_;
@@ -78,7 +103,10 @@ class AVADA_PUBLIC Buffer {
   const Cell& operator()(int i, int j) const noexcept;
 
  private:
-  friend void render(Buffer&, Buffer&, const TerminalCapabilities&);
+  friend bool render(Buffer&,
+                     Buffer&,
+                     const TerminalCapabilities&,
+                     const RenderOptions&);
 
   int rows_;
   int columns_;
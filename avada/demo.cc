@@ -30,7 +30,7 @@ class EventHandler {
   }
 
   void operator()(avada::input::ResizeEvent resize) {
-    LOG() << "ResizeEvent: " << resize.rows << " x " << resize.columns;
+    LOG(INPUT, INFO) << "ResizeEvent: " << resize.rows << " x " << resize.columns;
     context_.render_buffer().clear();
     render_scene(context_.render_buffer(), '$');
     context_.render();
@@ -38,6 +38,10 @@ class EventHandler {
 
   void operator()(avada::input::ServiceEvent) {}
 
+  void operator()(const avada::input::PasteEvent& ev) {
+    LOG(INPUT, INFO) << "Pasted " << ev.text.size() << " bytes";
+  }
+
   void operator()(avada::input::KeyboardEvent ev) {
     using namespace avada::input;
     if (ev == KeyboardEvent{L'q', KeyboardEvent::CTRL}) {
@@ -49,7 +53,7 @@ class EventHandler {
       render_scene(context_.render_buffer(), '@');
       context_.render();
     }
-    LOG() << "KeyboardEvent: " << ev.to_string();
+    LOG(INPUT, VERBOSE) << "KeyboardEvent: " << ev.to_string();
   }
 
   void operator()(avada::input::MouseEvent ev) {
@@ -64,16 +68,18 @@ class EventHandler {
                                     draw(context_.render_buffer(), ev.x, ev.y);
                                 },
                                 [this](MouseEvent::Scroll scroll) {
-                                  LOG() << "old green: " << (int)color_.green();
+                                  LOG(RENDER, VERBOSE)
+                                      << "old green: " << (int)color_.green();
                                   if (scroll == MouseEvent::Scroll::UP) {
                                     color_.green() = std::min(color_.green() + 1, 255);
                                   } else {
                                     color_.green() = std::max(color_.green() - 1, 0);
                                   }
-                                  LOG() << "new green: " << (int)color_.green();
+                                  LOG(RENDER, VERBOSE)
+                                      << "new green: " << (int)color_.green();
                                 }},
                ev.data);
-    LOG() << "MouseEvent: " << ev.to_string();
+    LOG(INPUT, VERBOSE) << "MouseEvent: " << ev.to_string();
   }
 
   bool should_exit() const noexcept { return should_exit_; }
@@ -104,7 +110,8 @@ class EventHandler {
     int i2 = i1 + h;
     int j2 = j1 + w;
 
-    LOG() << "w: " << w << "; h: " << h << "; i1: " << i1 << "; j1: " << j1;
+    LOG(RENDER, VERBOSE) << "w: " << w << "; h: " << h << "; i1: " << i1
+                         << "; j1: " << j1;
 
     for (int i = i1; i < i2; ++i) {
       for (int j = j1; j < j2; ++j) {
@@ -118,7 +125,7 @@ class EventHandler {
         if (i >= buffer.columns())
           break;
         buffer(1, i++).set_data(ch);
-        LOG() << "Set " << ch << " to (1, " << i << ")";
+        LOG(RENDER, VERBOSE) << "Set " << ch << " to (1, " << i << ")";
       }
     }
   }
@@ -134,6 +141,7 @@ class EventHandler {
 
 int main() {
   using namespace std::chrono_literals;
+  avada::block_resize_signal();
   base::debug::LoggerToStdErr logger;
   base::debug::setup_logging(&logger);
 
@@ -143,10 +151,9 @@ int main() {
 
     EventHandler hander{context};
     while (!hander.should_exit()) {
-      try {
-        std::visit(hander, context.poll_event(1s));
-      } catch (avada::input::unparsed_exception& e) {
-        LOG() << "Unparsed exception: " << e.what();
+      context.poll_events(1s);
+      while (auto event = context.next_event()) {
+        std::visit(hander, *event);
       }
     }
 
@@ -154,10 +161,10 @@ int main() {
     return 0;
 
   } catch (base::system_exception& e) {
-    LOG() << "System exception: " << e.stack_trace().to_string(e.what());
+    LOG(GENERAL, ERROR) << "System exception: " << e.stack_trace().to_string(e.what());
     return 1;
   } catch (std::exception& e) {
-    LOG() << "Unexpected exception: " << e.what();
+    LOG(GENERAL, ERROR) << "Unexpected exception: " << e.what();
     return 2;
   }
 }
@@ -15,18 +15,23 @@
 
 #include "avada/input.hpp"
 
+#include "avada/buffer.hpp"
 #include "base/debug/debug.hpp"
 #include "base/util.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cwctype>
 #include <sstream>
 
 namespace avada::input {
 
 namespace {
 
-int parse_decimal(std::string_view::iterator& i) {
+// Stops at the first non-digit or at the `end`, the sequence may be cut.
+int parse_decimal(std::string_view::iterator& i, std::string_view::iterator end) {
   int num = 0;
-  while (*i >= '0' && *i <= '9') {
+  while (i != end && *i >= '0' && *i <= '9') {
     num = num * 10 + (*i++ - '0');
   }
   return num;
@@ -73,6 +78,355 @@ const char* keyboard_key_repr(KeyboardKey key) {
   return "<?KEY?>";
 }
 
+struct KeymapEntry {
+  std::string_view sequence;
+  std::variant<wchar_t, KeyboardKey> key;
+  uint8_t modifiers = 0x0;
+
+  KeyboardEvent event() const noexcept {
+    return std::visit([this](auto key) { return KeyboardEvent{key, modifiers}; }, key);
+  }
+};
+
+// clang-format off
+constexpr KeymapEntry kKeymapEntries[] = {
+  {"\x7F",      KeyboardKey::BACKSPACE},
+  {"\xD",       KeyboardKey::ENTER},
+  {"\x1B" "OM", KeyboardKey::ENTER},
+  {"\x1B",      KeyboardKey::ESCAPE},
+  {"\x1B[2~",   KeyboardKey::INSERT},
+  {"\x1B[3~",   KeyboardKey::DELETE},
+
+  {"\x1B" "Ok", L'+'},
+  {"\x1B" "Om", L'-'},
+  {"\x1B" "Oj", L'*'},
+  {"\x1B" "Oo", L'/'},
+
+  {"\x1B[H",  KeyboardKey::HOME},  {"\x1B[1H", KeyboardKey::HOME},
+  {"\x1B[F",  KeyboardKey::END},   {"\x1B[1F", KeyboardKey::END},
+  {"\x1B[E",  KeyboardKey::FIRE},  {"\x1B[1E", KeyboardKey::FIRE},
+
+  {"\x1B[A",  KeyboardKey::UP},    {"\x1B[1A", KeyboardKey::UP},
+  {"\x1B[B",  KeyboardKey::DOWN},  {"\x1B[1B", KeyboardKey::DOWN},
+  {"\x1B[C",  KeyboardKey::RIGHT}, {"\x1B[1C", KeyboardKey::RIGHT},
+  {"\x1B[D",  KeyboardKey::LEFT},  {"\x1B[1D", KeyboardKey::LEFT},
+
+  {"\x1B[5~", KeyboardKey::PAGE_UP},
+  {"\x1B[6~", KeyboardKey::PAGE_DOWN},
+
+  {"\x1BOP",  KeyboardKey::F1},    {"\x1B[1P", KeyboardKey::F1},
+  {"\x1BOQ",  KeyboardKey::F2},    {"\x1B[1Q", KeyboardKey::F2},
+  {"\x1BOR",  KeyboardKey::F3},    {"\x1B[1R", KeyboardKey::F3},
+  {"\x1BOS",  KeyboardKey::F4},    {"\x1B[1S", KeyboardKey::F4},
+
+  {"\x1B[15~", KeyboardKey::F5},
+  {"\x1B[17~", KeyboardKey::F6},
+  {"\x1B[18~", KeyboardKey::F7},
+  {"\x1B[19~", KeyboardKey::F8},
+  {"\x1B[20~", KeyboardKey::F9},
+  {"\x1B[21~", KeyboardKey::F10},
+  {"\x1B[23~", KeyboardKey::F11},
+  {"\x1B[24~", KeyboardKey::F12},
+
+  {"\x9",      KeyboardKey::TAB},
+  {"\x20",     KeyboardKey::SPACE},
+
+  {{"\0", 1},  KeyboardKey::SPACE, KeyboardEvent::CTRL},
+  {"\x1B[Z",   KeyboardKey::TAB,   KeyboardEvent::SHIFT},
+};
+// clang-format on
+
+// FNV-1a with a murmur3 finalizer, so the low bits are usable as a table index.
+constexpr uint32_t hash_sequence(uint32_t seed, std::string_view sequence) noexcept {
+  uint32_t hash = 2166136261u ^ seed;
+  for (char c : sequence) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+// Perfect hash table over the keymap entries, the seed is searched at compile time.
+class Keymap {
+ public:
+  static constexpr std::size_t kSlots = 256;
+  static_assert(std::size(kKeymapEntries) < kSlots / 2);
+
+  consteval Keymap() : seed_(0), slots_{} {
+    for (uint32_t seed = 1; seed < (1 << 16); ++seed) {
+      if (try_seed(seed)) {
+        seed_ = seed;
+        return;
+      }
+    }
+  }
+
+  constexpr bool valid() const noexcept { return seed_ != 0; }
+
+  constexpr const KeymapEntry* find(std::string_view sequence) const noexcept {
+    const auto slot = slots_[hash_sequence(seed_, sequence) % kSlots];
+    if (slot == 0)
+      return nullptr;
+    const auto& entry = kKeymapEntries[slot - 1];
+    if (entry.sequence != sequence)
+      return nullptr;
+    return &entry;
+  }
+
+ private:
+  consteval bool try_seed(uint32_t seed) {
+    slots_ = {};
+    for (std::size_t i = 0; i < std::size(kKeymapEntries); ++i) {
+      auto& slot = slots_[hash_sequence(seed, kKeymapEntries[i].sequence) % kSlots];
+      if (slot != 0)
+        return false;
+      slot = static_cast<uint8_t>(i + 1);
+    }
+    return true;
+  }
+
+  uint32_t seed_;
+  // Index of the entry + 1, zero means an empty slot.
+  std::array<uint8_t, kSlots> slots_;
+};
+
+constexpr Keymap kKeymap;
+static_assert(kKeymap.valid(), "No perfect hash seed for the keymap");
+static_assert(kKeymap.find("\x1B[24~") != nullptr);
+
+// Decodes the xterm modifier parameter: 1 + (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0).
+// The kitty protocol adds higher bits (super, hyper, etc.), which are ignored.
+constexpr uint8_t decode_modifiers(int param) noexcept {
+  const int bits = param - 1;
+  return ((bits & 0b001) ? KeyboardEvent::SHIFT : 0x0) |
+         ((bits & 0b010) ? KeyboardEvent::ALT : 0x0) |
+         ((bits & 0b100) ? KeyboardEvent::CTRL : 0x0);
+}
+
+struct CsiKeyEntry {
+  char final;
+  int number;
+  KeyboardKey key;
+};
+
+// Keys reported as `CSI [number] [; modifiers] final`, besides `CSI ... u`.
+// clang-format off
+constexpr CsiKeyEntry kCsiKeys[] = {
+  {'A', 1, KeyboardKey::UP},    {'B', 1, KeyboardKey::DOWN},
+  {'C', 1, KeyboardKey::RIGHT}, {'D', 1, KeyboardKey::LEFT},
+  {'H', 1, KeyboardKey::HOME},  {'F', 1, KeyboardKey::END},
+  {'E', 1, KeyboardKey::FIRE},
+  {'P', 1, KeyboardKey::F1},    {'Q', 1, KeyboardKey::F2},
+  {'R', 1, KeyboardKey::F3},    {'S', 1, KeyboardKey::F4},
+
+  {'~', 2, KeyboardKey::INSERT},  {'~', 3, KeyboardKey::DELETE},
+  {'~', 1, KeyboardKey::HOME},    {'~', 7, KeyboardKey::HOME},
+  {'~', 4, KeyboardKey::END},     {'~', 8, KeyboardKey::END},
+  {'~', 5, KeyboardKey::PAGE_UP}, {'~', 6, KeyboardKey::PAGE_DOWN},
+
+  {'~', 11, KeyboardKey::F1},  {'~', 12, KeyboardKey::F2},
+  {'~', 13, KeyboardKey::F3},  {'~', 14, KeyboardKey::F4},
+  {'~', 15, KeyboardKey::F5},  {'~', 17, KeyboardKey::F6},
+  {'~', 18, KeyboardKey::F7},  {'~', 19, KeyboardKey::F8},
+  {'~', 20, KeyboardKey::F9},  {'~', 21, KeyboardKey::F10},
+  {'~', 23, KeyboardKey::F11}, {'~', 24, KeyboardKey::F12},
+};
+// clang-format on
+
+struct KittyKeyEntry {
+  uint32_t code;
+  std::variant<wchar_t, KeyboardKey> key;
+};
+
+// Key codes of the kitty keyboard protocol, which are not just the characters. Codes
+// from 57344 on are in the Unicode Private Use Area.
+// clang-format off
+constexpr KittyKeyEntry kKittyKeys[] = {
+  {9,     KeyboardKey::TAB},       {13,    KeyboardKey::ENTER},
+  {27,    KeyboardKey::ESCAPE},    {32,    KeyboardKey::SPACE},
+  {127,   KeyboardKey::BACKSPACE},
+
+  // Keypad.
+  {57399, L'0'}, {57400, L'1'}, {57401, L'2'}, {57402, L'3'}, {57403, L'4'},
+  {57404, L'5'}, {57405, L'6'}, {57406, L'7'}, {57407, L'8'}, {57408, L'9'},
+  {57409, L'.'}, {57410, L'/'}, {57411, L'*'}, {57412, L'-'}, {57413, L'+'},
+  {57414, KeyboardKey::ENTER},     {57415, L'='},
+  {57417, KeyboardKey::LEFT},      {57418, KeyboardKey::RIGHT},
+  {57419, KeyboardKey::UP},        {57420, KeyboardKey::DOWN},
+  {57421, KeyboardKey::PAGE_UP},   {57422, KeyboardKey::PAGE_DOWN},
+  {57423, KeyboardKey::HOME},      {57424, KeyboardKey::END},
+  {57425, KeyboardKey::INSERT},    {57426, KeyboardKey::DELETE},
+  {57427, KeyboardKey::FIRE},
+};
+// clang-format on
+
+constexpr uint32_t kKittyPrivateKeysStart = 57344;
+constexpr uint32_t kKittyPrivateKeysEnd = 63743;
+
+std::pair<std::string_view, std::string_view> split(std::string_view data, char sep) {
+  const auto pos = data.find(sep);
+  if (pos == std::string_view::npos)
+    return {data, {}};
+  return {data.substr(0, pos), data.substr(pos + 1)};
+}
+
+// No key code, modifier mask or action goes beyond the Unicode range.
+constexpr int kMaxParameter = 0x10FFFF;
+
+// Parses an optional CSI parameter, which defaults to 1.
+std::optional<int> parse_parameter(std::string_view data) noexcept {
+  int value = 0;
+  for (char c : data) {
+    if (c < '0' || c > '9')
+      return {};
+    value = value * 10 + (c - '0');
+    // Checked on every digit, so it never overflows.
+    if (value > kMaxParameter)
+      return {};
+  }
+  return data.empty() ? 1 : value;
+}
+
+// Decodes `CSI number[:alternates] ; modifiers[:action] [; text] final`. This covers
+// both the xterm modified keys, e.g. `CSI 1 ; 5 A` for `CTRL` + Up, and the kitty
+// keyboard protocol `CSI ... u` reports.
+std::optional<KeyboardEvent> decode_csi_key(std::string_view data) noexcept {
+  if (data.size() < 3 || !data.starts_with("\x1B["))
+    return {};
+  const auto final = data.back();
+  const auto [number_field, rest] = split(data.substr(2, data.size() - 3), ';');
+  const auto [modifiers_field, text_field] = split(rest, ';');
+  const auto [modifiers_part, action_part] = split(modifiers_field, ':');
+
+  const auto number = parse_parameter(split(number_field, ':').first);
+  const auto modifiers = parse_parameter(modifiers_part);
+  const auto action = parse_parameter(action_part);
+  if (!number || !modifiers || !action || *action < 1 || *action > 3)
+    return {};
+
+  std::optional<KeyboardEvent> event;
+  if (final == 'u') {
+    const auto code = static_cast<uint32_t>(*number);
+    for (const auto& entry : kKittyKeys) {
+      if (entry.code == code) {
+        event = std::visit([](auto key) { return KeyboardEvent{key}; }, entry.key);
+        break;
+      }
+    }
+    if (!event && (code < kKittyPrivateKeysStart || code > kKittyPrivateKeysEnd)) {
+      event = KeyboardEvent{static_cast<wchar_t>(code)};
+    }
+  } else {
+    for (const auto& entry : kCsiKeys) {
+      if (entry.final == final && entry.number == *number) {
+        event = KeyboardEvent{entry.key};
+        break;
+      }
+    }
+  }
+  if (!event)
+    return {};
+
+  event->modifiers = decode_modifiers(*modifiers);
+  event->action = static_cast<KeyboardEvent::Action>(*action - 1);
+  if (auto* ch = std::get_if<wchar_t>(&event->key); ch && event->shift()) {
+    // Characters are reported unshifted, keep them consistent with the legacy input.
+    *ch = std::towupper(*ch);
+  }
+  return event;
+}
+
+// Decodes the data if it is exactly a single UTF-8 encoded code point.
+std::optional<wchar_t> decode_utf8(std::string_view data) noexcept {
+  const auto lead = static_cast<uint8_t>(data[0]);
+  std::size_t length;
+  wchar_t wch;
+  if ((lead & 0b11100000) == 0b11000000) {
+    length = 2;
+    wch = lead & 0b00011111;
+  } else if ((lead & 0b11110000) == 0b11100000) {
+    length = 3;
+    wch = lead & 0b00001111;
+  } else if ((lead & 0b11111000) == 0b11110000) {
+    length = 4;
+    wch = lead & 0b00000111;
+  } else {
+    return {};
+  }
+  if (data.size() != length)
+    return {};
+  for (std::size_t i = 1; i < length; ++i) {
+    const auto continuation = static_cast<uint8_t>(data[i]);
+    if ((continuation & 0b11000000) != 0b10000000)
+      return {};
+    wch = (wch << 6) | (continuation & 0b00111111);
+  }
+  return wch;
+}
+
+// Returns the length of the first sequence in the non-empty `data`, or 0 if the
+// sequence is incomplete yet. If `final` is set, the incomplete sequence is cut to
+// what can be parsed on its own, e.g. lone `ESC` is the Escape key.
+std::size_t sequence_length(std::string_view data, bool final) noexcept {
+  const auto lead = static_cast<uint8_t>(data[0]);
+  if (lead == 0x1B) {
+    if (data.size() == 1)
+      return final ? 1 : 0;
+
+    switch (data[1]) {
+      case '[':
+        // CSI: parameter and intermediate bytes, terminated by the final byte.
+        for (std::size_t i = 2; i < data.size(); ++i) {
+          const auto ch = static_cast<uint8_t>(data[i]);
+          if (ch >= 0x40 && ch <= 0x7E)
+            return i + 1;
+          if (ch < 0x20 || ch > 0x7E)
+            return i;  // Malformed, cut it here.
+        }
+        // `ALT` + '[' or a truncated sequence, which is dropped as a whole.
+        return final ? data.size() : 0;
+      case 'O':
+        // SS3: a single final byte.
+        if (data.size() >= 3)
+          return 3;
+        return final ? 2 : 0;
+      default: {
+        // `ALT` + <key>, where the key may be a sequence itself.
+        const auto length = sequence_length(data.substr(1), final);
+        return length ? length + 1 : 0;
+      }
+    }
+  }
+
+  std::size_t length = 1;
+  if ((lead & 0b11100000) == 0b11000000) {
+    length = 2;
+  } else if ((lead & 0b11110000) == 0b11100000) {
+    length = 3;
+  } else if ((lead & 0b11111000) == 0b11110000) {
+    length = 4;
+  }
+  if (data.size() >= length)
+    return length;
+  return final ? data.size() : 0;
+}
+
+// Whether the `next` event supersedes the `previous` one.
+bool coalesces(const Event& previous, const Event& next) noexcept {
+  const auto* previous_mouse = std::get_if<MouseEvent>(&previous);
+  const auto* next_mouse = std::get_if<MouseEvent>(&next);
+  return previous_mouse && next_mouse && previous_mouse->motion() &&
+         next_mouse->motion() && previous_mouse->held_button == next_mouse->held_button;
+}
+
+constexpr std::string_view kPasteStart = "\x1B[200~";
+constexpr std::string_view kPasteEnd = "\x1B[201~";
+
 [[noreturn]] void handle_unparsed_input(std::string_view data) /* throws */ {
   // This is debug for unparsed input.
   if (data.size() == 1u) {
@@ -102,6 +456,11 @@ KeyboardEvent& KeyboardEvent::operator=(KeyboardKey k) noexcept {
   return *this;
 }
 
+void KeyboardEvent::set_raw_value(std::string_view raw) noexcept {
+  raw_size_ = static_cast<uint8_t>(std::min(raw.size(), kMaxRawSize));
+  std::copy_n(raw.begin(), raw_size_, raw_.begin());
+}
+
 std::wstring KeyboardEvent::to_string() const {
   std::wostringstream oss;
   if (modifiers & CTRL)
@@ -113,6 +472,10 @@ std::wstring KeyboardEvent::to_string() const {
   std::visit(base::overloaded{[&oss](wchar_t ch) { oss << ch; },
                               [&oss](KeyboardKey k) { oss << keyboard_key_repr(k); }},
              key);
+  if (action == Action::REPEAT)
+    oss << " [repeat]";
+  if (action == Action::RELEASE)
+    oss << " [release]";
   return oss.str();
 }
 
@@ -120,7 +483,9 @@ std::string MouseEvent::to_string() const noexcept {
   std::ostringstream oss;
   oss << '(' << x << ", " << y << ')';
   std::visit(base::overloaded{
-                 [&oss](std::monostate) { oss << " [move]"; },
+                 [this, &oss](std::monostate) {
+                   oss << (held_button ? " [drag]" : " [move]");
+                 },
                  [&oss](ButtonEvent ev) {
                    oss << ' ';
                    switch (ev.code) {
@@ -144,40 +509,123 @@ std::string MouseEvent::to_string() const noexcept {
   return oss.str();
 }
 
-InputParser::InputParser() noexcept {
-  init_keymap();
-}
+InputParser::InputParser() noexcept = default;
 
 Event InputParser::parse_event(std::string_view data) {
+  if (auto event = try_parse_event(data)) {
+    return std::move(*event);
+  }
+
+  handle_unparsed_input(data);
+}
+
+void InputParser::parse(std::string_view data, std::vector<Event>& events) {
+  if (pending_.empty()) {
+    // Fast path: parse right from the `data`, only the incomplete tail is copied.
+    const auto consumed = consume(data, /*final=*/false, events);
+    pending_.assign(data.substr(consumed));
+  } else {
+    pending_.append(data);
+    pending_.erase(0, consume(pending_, /*final=*/false, events));
+  }
+
+  if (!pending_.empty()) {
+    pending_since_ = clock::now();
+  }
+}
+
+void InputParser::flush_expired(std::vector<Event>& events) {
+  if (pending_.empty() || clock::now() - pending_since_ < kEscapeTimeout)
+    return;
+
+  consume(pending_, /*final=*/true, events);
+  pending_.clear();
+}
+
+std::optional<std::chrono::milliseconds> InputParser::pending_timeout() const noexcept {
+  if (pending_.empty())
+    return {};
+
+  const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+      kEscapeTimeout - (clock::now() - pending_since_));
+  return std::max(left, std::chrono::milliseconds::zero());
+}
+
+std::size_t InputParser::consume(std::string_view data,
+                                 bool final,
+                                 std::vector<Event>& events) {
+  std::size_t consumed = 0;
+  while (consumed < data.size()) {
+    if (paste_) {
+      consumed += consume_paste(data.substr(consumed), events);
+      continue;
+    }
+
+    const auto length = sequence_length(data.substr(consumed), final);
+    if (length == 0)
+      break;
+
+    const auto sequence = data.substr(consumed, length);
+    if (sequence == kPasteStart) {
+      paste_.emplace();
+    } else if (auto event = try_parse_event(sequence)) {
+      if (!events.empty() && coalesces(events.back(), *event)) {
+        events.back() = std::move(*event);
+      } else {
+        events.push_back(std::move(*event));
+      }
+    } else {
+      LOG(INPUT, WARNING) << "Unparsed input: "
+                          << internal::escape_for_log(std::string(sequence));
+    }
+    consumed += length;
+  }
+  return consumed;
+}
+
+std::size_t InputParser::consume_paste(std::string_view data,
+                                       std::vector<Event>& events) {
+  // The end marker may be split between reads, so the search starts a bit before the
+  // new data. `find` boils down to `memchr` for the leading `ESC`, which is rare in
+  // pasted text, so the scan runs at memory speed.
+  const auto old_size = paste_->size();
+  const auto search_from = old_size - std::min(old_size, kPasteEnd.size() - 1);
+  paste_->append(data);
+  const auto end = std::string_view(*paste_).find(kPasteEnd, search_from);
+  if (end == std::string_view::npos)
+    return data.size();
+
+  paste_->resize(end);
+  events.push_back(PasteEvent{std::move(*paste_)});
+  paste_.reset();
+  return end + kPasteEnd.size() - old_size;
+}
+
+std::optional<Event> InputParser::try_parse_event(std::string_view data) {
   if (auto ko = parse_mouse_event(data); ko.has_value()) {
     return ko.value();
   }
 
   if (auto ko = parse_keyboard_event(data); ko.has_value()) {
-    ko->raw_value = data;
+    ko->set_raw_value(data);
     return ko.value();
   }
 
-  handle_unparsed_input(data);
+  return {};
 }
 
 std::optional<KeyboardEvent> InputParser::parse_keyboard_event(
     std::string_view data) noexcept {
   // Try to match by keymap.
-  if (auto key = keymap_.find(data); key != keymap_.end()) {
-    return key->second;
+  if (auto* entry = kKeymap.find(data)) {
+    return entry->event();
   }
 
   if (data.size() == 1) {
     auto ch = data[0];
 
-    if (ch == 0) {
-      // Weird, but true.
-      return KeyboardEvent{KeyboardKey::SPACE, KeyboardEvent::CTRL};
-    }
-
     if (ch == 0x1f) {
-      // Also weird, but true.
+      // Weird, but true.
       return KeyboardEvent{'/', KeyboardEvent::CTRL};
     }
 
@@ -201,44 +649,9 @@ std::optional<KeyboardEvent> InputParser::parse_keyboard_event(
     }
   }
 
-  // Try to match escape seq with detailed modifier info.
-  if (data.size() > 3 && data[0] == '\x1B') {
-    auto it = data.rbegin();
-    if (std::isprint(*it++)) {
-      auto num = *it++;
-      int has_semicolon = static_cast<int>(*it == ';');
-
-      auto copy = std::string{data};
-      copy.erase(copy.size() - 2 - has_semicolon, 1 + has_semicolon);
-      if (auto key_it = keymap_.find(copy); key_it != keymap_.end()) {
-        auto key = key_it->second;
-        switch (num) {
-          case '2':
-            key.modifiers = KeyboardEvent::SHIFT;
-            break;
-          case '3':
-            key.modifiers = KeyboardEvent::ALT;
-            break;
-          case '4':
-            key.modifiers = KeyboardEvent::ALT | KeyboardEvent::SHIFT;
-            break;
-          case '5':
-            key.modifiers = KeyboardEvent::CTRL;
-            break;
-          case '6':
-            key.modifiers = KeyboardEvent::CTRL | KeyboardEvent::SHIFT;
-            break;
-          case '7':
-            key.modifiers = KeyboardEvent::ALT | KeyboardEvent::CTRL;
-            break;
-          case '8':
-            key.modifiers =
-                KeyboardEvent::ALT | KeyboardEvent::SHIFT | KeyboardEvent::CTRL;
-            break;
-        }
-        return key;
-      }
-    }
+  // Try to decode escape seq with detailed modifier info or a kitty protocol report.
+  if (auto key = decode_csi_key(data)) {
+    return key;
   }
 
   // Try to match ALT + <KEY>.
@@ -258,10 +671,8 @@ std::optional<KeyboardEvent> InputParser::parse_keyboard_event(
 
   // Try to convert from UTF-8
   if (data.size() > 1) {
-    LOG() << "Try to use utf8 cvt on " << data << " with size " << data.size();
-    auto wstr = utf8_cvt_.from_bytes(data.begin(), data.end());
-    if (utf8_cvt_.converted() == data.size() && wstr.size() == 1) {
-      return KeyboardEvent{wstr[0]};
+    if (auto wch = decode_utf8(data)) {
+      return KeyboardEvent{*wch};
     }
   }
 
@@ -272,24 +683,22 @@ std::optional<KeyboardEvent> InputParser::parse_keyboard_event(
 std::optional<input::MouseEvent> InputParser::parse_mouse_event(
     std::string_view data) noexcept {
   using namespace input;
-  auto i = data.begin();
-  if (*i++ != '\x1B')
-    return {};
-  if (*i++ != '[')
-    return {};
-  if (*i++ != '<')
+  if (!data.starts_with("\x1B[<"))
     return {};
+  // The flushed incomplete sequences get here as well, so the input may run out.
+  auto i = data.begin() + 3;
+  const auto end = data.end();
 
-  int cb = parse_decimal(i);
-  if (*i++ != ';')
+  int cb = parse_decimal(i, end);
+  if (i == end || *i++ != ';')
     return {};
 
-  int cx = parse_decimal(i);
-  if (*i++ != ';')
+  int cx = parse_decimal(i, end);
+  if (i == end || *i++ != ';')
     return {};
 
-  int cy = parse_decimal(i);
-  if (*i != 'm' && *i != 'M')
+  int cy = parse_decimal(i, end);
+  if (i == end || (*i != 'm' && *i != 'M'))
     return {};
 
   input::MouseEvent mev{cx - 1, cy - 1};
@@ -324,57 +733,17 @@ std::optional<input::MouseEvent> InputParser::parse_mouse_event(
       default:
         return {};
     }
+  } else if ((cb & 0b11) != 0b11) {
+    // Mouse move event with a button held.
+    constexpr MouseEvent::Button kButtons[] = {
+        MouseEvent::Button::LEFT,
+        MouseEvent::Button::MIDDLE,
+        MouseEvent::Button::RIGHT,
+    };
+    mev.held_button = kButtons[cb & 0b11];
   }
-  // Or mouse move event
 
   return mev;
 }
 
-void InputParser::init_keymap() noexcept {
-  // clang-format off
-  keymap_["\x7F"] =      KeyboardKey::BACKSPACE;
-  keymap_["\xD"] = keymap_["\x1B" "OM"] =  KeyboardKey::ENTER;
-  keymap_["\x1B"] =      KeyboardKey::ESCAPE;
-  keymap_["\x1B[2~"] =   KeyboardKey::INSERT;
-  keymap_["\x1B[3~"] =   KeyboardKey::DELETE;
-
-  keymap_["\x1B" "Ok"] = '+';
-  keymap_["\x1B" "Om"] = '-';
-  keymap_["\x1B" "Oj"] = '*';
-  keymap_["\x1B" "Oo"] = '/';
-
-  keymap_["\x1B[H"] = keymap_["\x1B[1H"] = KeyboardKey::HOME;
-  keymap_["\x1B[F"] = keymap_["\x1B[1F"] = KeyboardKey::END;
-  keymap_["\x1B[E"] = keymap_["\x1B[1E"] = KeyboardKey::FIRE;
-
-  keymap_["\x1B[A"] = keymap_["\x1B[1A"] = KeyboardKey::UP;
-  keymap_["\x1B[B"] = keymap_["\x1B[1B"] = KeyboardKey::DOWN;
-  keymap_["\x1B[C"] = keymap_["\x1B[1C"] = KeyboardKey::RIGHT;
-  keymap_["\x1B[D"] = keymap_["\x1B[1D"] = KeyboardKey::LEFT;
-
-  keymap_["\x1B[5~"] =   KeyboardKey::PAGE_UP;
-  keymap_["\x1B[6~"] =   KeyboardKey::PAGE_DOWN;
-
-  keymap_["\x1BOP"] = keymap_["\x1B[1P"] = KeyboardKey::F1;
-  keymap_["\x1BOQ"] = keymap_["\x1B[1Q"] = KeyboardKey::F2;
-  keymap_["\x1BOR"] = keymap_["\x1B[1R"] = KeyboardKey::F3;
-  keymap_["\x1BOS"] = keymap_["\x1B[1S"] = KeyboardKey::F4;
-
-  keymap_["\x1B[15~"] =  KeyboardKey::F5;
-  keymap_["\x1B[17~"] =  KeyboardKey::F6;
-  keymap_["\x1B[18~"] =  KeyboardKey::F7;
-  keymap_["\x1B[19~"] =  KeyboardKey::F8;
-  keymap_["\x1B[20~"] =  KeyboardKey::F9;
-  keymap_["\x1B[21~"] =  KeyboardKey::F10;
-  keymap_["\x1B[23~"] =  KeyboardKey::F11;
-  keymap_["\x1B[24~"] =  KeyboardKey::F12;
-
-  keymap_["\x9"] =       KeyboardKey::TAB;
-  keymap_["\x20"] =      KeyboardKey::SPACE;
-
-  keymap_["\0"] =        KeyboardEvent{KeyboardKey::SPACE, KeyboardEvent::CTRL};
-  keymap_["\x1B[Z"] =    KeyboardEvent{KeyboardKey::TAB, KeyboardEvent::SHIFT};
-  // clang-format on
-}
-
 }  // namespace avada::input
@@ -20,13 +20,15 @@
 
 #include "avada/config.hpp"
 
-#include <codecvt>
+#include <array>
+#include <chrono>
 #include <cstdint>
-#include <locale>
-#include <map>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <variant>
+#include <vector>
 
 namespace avada::input {
 
@@ -69,9 +71,20 @@ enum class AVADA_PUBLIC ServiceEvent {
 
 class AVADA_PUBLIC KeyboardEvent {
  public:
+  // Repeats and releases are only reported by terminals supporting the kitty keyboard
+  // protocol.
+  enum class Action : uint8_t {
+    PRESS,
+    REPEAT,
+    RELEASE,
+  };
+
+  // Longer raw sequences are truncated, they are for debugging purposes anyway.
+  static constexpr std::size_t kMaxRawSize = 16;
+
   std::variant<wchar_t, KeyboardKey> key;
   uint8_t modifiers;
-  std::string raw_value;
+  Action action = Action::PRESS;
 
   constexpr static uint8_t ALT = 0x1;
   constexpr static uint8_t CTRL = 0x2;
@@ -90,6 +103,11 @@ class AVADA_PUBLIC KeyboardEvent {
   GETTER inline bool alt() const { return modifiers & ALT; }
   GETTER inline bool ctrl() const { return modifiers & CTRL; }
   GETTER inline bool shift() const { return modifiers & SHIFT; }
+  GETTER inline bool released() const { return action == Action::RELEASE; }
+
+  // The sequence, the event is parsed from.
+  GETTER std::string_view raw_value() const noexcept { return {raw_.data(), raw_size_}; }
+  void set_raw_value(std::string_view raw) noexcept;
 
   bool operator==(const KeyboardEvent& rhs) const {
     return key == rhs.key && modifiers == rhs.modifiers;
@@ -97,6 +115,10 @@ class AVADA_PUBLIC KeyboardEvent {
   bool operator!=(const KeyboardEvent& rhs) const {
     return key != rhs.key || modifiers != rhs.modifiers;
   }
+
+ private:
+  uint8_t raw_size_ = 0;
+  std::array<char, kMaxRawSize> raw_;
 };
 
 class AVADA_PUBLIC MouseEvent {
@@ -123,16 +145,37 @@ class AVADA_PUBLIC MouseEvent {
     auto operator<=>(const ButtonEvent&) const = default;
   };
 
+  // `std::monostate` stands for mouse motion.
   std::variant<std::monostate, ButtonEvent, Scroll> data;
 
+  // The button held during the motion, if any.
+  std::optional<Button> held_button;
+
   MouseEvent(int x, int y) : x(x), y(y), data() {}
   MouseEvent(int x, int y, ButtonEvent btn) : x(x), y(y), data(btn) {}
   MouseEvent(int x, int y, Scroll scrl) : x(x), y(y), data(scrl) {}
 
+  GETTER bool motion() const noexcept {
+    return std::holds_alternative<std::monostate>(data);
+  }
+
   std::string to_string() const noexcept;
 };
 
-using Event = std::variant<ServiceEvent, ResizeEvent, KeyboardEvent, MouseEvent>;
+// Text, pasted while bracketed paste mode is on. Delivered as a whole, however large
+// the paste is, instead of a keyboard event per character.
+struct AVADA_PUBLIC PasteEvent {
+  std::string text;
+};
+
+// Events are passed by value between threads, so they are kept small and plain. Only
+// paste owns memory, and it's rather rare.
+static_assert(std::is_trivially_copyable_v<ResizeEvent>);
+static_assert(std::is_trivially_copyable_v<KeyboardEvent>);
+static_assert(std::is_trivially_copyable_v<MouseEvent>);
+
+using Event =
+    std::variant<ServiceEvent, ResizeEvent, KeyboardEvent, MouseEvent, PasteEvent>;
 
 class AVADA_PUBLIC unparsed_exception : public base::exception {
  public:
@@ -140,23 +183,55 @@ class AVADA_PUBLIC unparsed_exception : public base::exception {
   unparsed_exception(Args&&... args) : exception(std::forward<Args>(args)...) {}
 };
 
-class InputParser {
+// Stateful input parser. Terminal input arrives in arbitrary chunks: a single `read`
+// may contain many events (fast typing, mouse motion, key repeat) or only a part of an
+// escape sequence. The parser splits the input into single sequences, yields all the
+// complete ones and keeps the incomplete tail until the next chunk arrives.
+// Consecutive mouse motion events with the same button held are coalesced into the
+// latest one, as only the final position matters for a frame.
+class AVADA_PUBLIC InputParser {
  public:
+  // A lone `ESC` (or an incomplete sequence starting with it) is only treated as the
+  // Escape key (or `ALT` + key) if nothing follows it within this time. With the kitty
+  // keyboard protocol on, these keys are reported as complete sequences and don't wait.
+  static constexpr std::chrono::milliseconds kEscapeTimeout{25};
+
   InputParser() noexcept;
 
+  // Parses a single complete sequence.
   Event parse_event(std::string_view data) /* throws */;
 
+  // Appends all the events, complete with the `data` chunk, to `events`. Sequences,
+  // which could not be parsed, are logged and skipped.
+  void parse(std::string_view data, std::vector<Event>& events);
+
+  // Appends pending input as events to `events`, if it is pending longer than
+  // `kEscapeTimeout`.
+  void flush_expired(std::vector<Event>& events);
+
+  // Time left until pending input expires, if there is any.
+  NODISCARD std::optional<std::chrono::milliseconds> pending_timeout() const noexcept;
+
  private:
+  using clock = std::chrono::steady_clock;
+
+  // Consumes complete sequences from the `data` and returns the number of bytes
+  // consumed. If `final` is set, incomplete sequences are consumed too.
+  std::size_t consume(std::string_view data, bool final, std::vector<Event>& events);
+
+  // Accumulates pasted text from the `data` up to the paste end marker and returns
+  // the number of bytes consumed.
+  std::size_t consume_paste(std::string_view data, std::vector<Event>& events);
+
+  std::optional<Event> try_parse_event(std::string_view data);
   std::optional<KeyboardEvent> parse_keyboard_event(std::string_view data) noexcept;
   std::optional<MouseEvent> parse_mouse_event(std::string_view data) noexcept;
 
- private:
-  void init_keymap() noexcept;
+  std::string pending_;
+  clock::time_point pending_since_;
 
- private:
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> utf8_cvt_;
-  std::map<std::string_view, KeyboardEvent> keymap_;
-  // TODO: throttle mouse move events.
+  // Text pasted so far, if inside bracketed paste. Grows across reads.
+  std::optional<std::string> paste_;
 };
 
 }  // namespace avada::input
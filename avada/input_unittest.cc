@@ -0,0 +1,169 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avada/input.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+using namespace avada::input;
+
+namespace {
+
+// Feeds the chunks one by one, as if they were separate reads.
+std::vector<Event> parse_chunks(InputParser& parser,
+                                std::initializer_list<std::string_view> chunks) {
+  std::vector<Event> events;
+  for (const auto chunk : chunks)
+    parser.parse(chunk, events);
+  return events;
+}
+
+KeyboardEvent key_of(const Event& event) {
+  EXPECT_TRUE(std::holds_alternative<KeyboardEvent>(event));
+  return std::get<KeyboardEvent>(event);
+}
+
+void wait_escape_timeout() {
+  std::this_thread::sleep_for(InputParser::kEscapeTimeout + std::chrono::milliseconds(5));
+}
+
+}  // namespace
+
+TEST(InputParserTest, MatchesKeymap) {
+  InputParser parser;
+  EXPECT_EQ(key_of(parser.parse_event("\x1B[A")), KeyboardEvent{KeyboardKey::UP});
+  EXPECT_EQ(key_of(parser.parse_event("\x1BOP")), KeyboardEvent{KeyboardKey::F1});
+  EXPECT_EQ(key_of(parser.parse_event("\x1B[24~")), KeyboardEvent{KeyboardKey::F12});
+  EXPECT_EQ(key_of(parser.parse_event("\x1B[1;5A")),
+            (KeyboardEvent{KeyboardKey::UP, KeyboardEvent::CTRL}));
+}
+
+TEST(InputParserTest, SplitsChunkIntoEvents) {
+  InputParser parser;
+  const auto events = parse_chunks(parser, {"a\x1B[Bb"});
+
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(key_of(events[0]), KeyboardEvent{L'a'});
+  EXPECT_EQ(key_of(events[1]), KeyboardEvent{KeyboardKey::DOWN});
+  EXPECT_EQ(key_of(events[2]), KeyboardEvent{L'b'});
+  EXPECT_FALSE(parser.pending_timeout());
+}
+
+TEST(InputParserTest, JoinsSequenceSplitBetweenReads) {
+  InputParser parser;
+  std::vector<Event> events;
+  parser.parse("\x1B[2", events);
+  EXPECT_TRUE(events.empty());
+  EXPECT_TRUE(parser.pending_timeout());
+
+  parser.parse("4~\xD0", events);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(key_of(events[0]), KeyboardEvent{KeyboardKey::F12});
+
+  // UTF-8 may be split as well.
+  parser.parse("\xAF", events);
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(key_of(events[1]), KeyboardEvent{L'\u042F'});
+}
+
+TEST(InputParserTest, JoinsMouseReportSplitBetweenReads) {
+  InputParser parser;
+  const auto events = parse_chunks(parser, {"\x1B[<0;10;", "5M"});
+
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_TRUE(std::holds_alternative<MouseEvent>(events[0]));
+  const auto& mouse = std::get<MouseEvent>(events[0]);
+  EXPECT_EQ(mouse.x, 9);
+  EXPECT_EQ(mouse.y, 4);
+  EXPECT_EQ(std::get<MouseEvent::ButtonEvent>(mouse.data),
+            (MouseEvent::ButtonEvent{MouseEvent::Button::LEFT,
+                                     MouseEvent::State::PRESSED}));
+}
+
+TEST(InputParserTest, LoneEscapeIsEscapeKeyAfterTimeout) {
+  InputParser parser;
+  std::vector<Event> events;
+  parser.parse("\x1B", events);
+  parser.flush_expired(events);
+  EXPECT_TRUE(events.empty());
+
+  wait_escape_timeout();
+  parser.flush_expired(events);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(key_of(events[0]), KeyboardEvent{KeyboardKey::ESCAPE});
+  EXPECT_FALSE(parser.pending_timeout());
+}
+
+TEST(InputParserTest, EscapeFollowedInTimeIsAlt) {
+  InputParser parser;
+  const auto events = parse_chunks(parser, {"\x1B", "x"});
+
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(key_of(events[0]), (KeyboardEvent{L'x', KeyboardEvent::ALT}));
+}
+
+TEST(InputParserTest, DropsCutMouseReportOnTimeout) {
+  InputParser parser;
+  std::vector<Event> events;
+  parser.parse("\x1B[<0;1", events);
+
+  wait_escape_timeout();
+  parser.flush_expired(events);
+  for (const auto& event : events)
+    EXPECT_FALSE(std::holds_alternative<MouseEvent>(event));
+  EXPECT_FALSE(parser.pending_timeout());
+}
+
+TEST(InputParserTest, JoinsPasteSplitBetweenReads) {
+  InputParser parser;
+  // The end marker is split as well.
+  const auto events =
+      parse_chunks(parser, {"\x1B[200~hel", "lo\x1B[A wor", "ld\x1B[20", "1~x"});
+
+  ASSERT_EQ(events.size(), 2u);
+  ASSERT_TRUE(std::holds_alternative<PasteEvent>(events[0]));
+  EXPECT_EQ(std::get<PasteEvent>(events[0]).text, "hello\x1B[A world");
+  EXPECT_EQ(key_of(events[1]), KeyboardEvent{L'x'});
+}
+
+TEST(InputParserTest, DecodesKittyKeys) {
+  InputParser parser;
+  const auto events =
+      parse_chunks(parser, {"\x1B[97;5u", "\x1B[97;2u", "\x1B[57419u", "\x1B[97;1:3u"});
+
+  ASSERT_EQ(events.size(), 4u);
+  EXPECT_EQ(key_of(events[0]), (KeyboardEvent{L'a', KeyboardEvent::CTRL}));
+  // Reported unshifted.
+  EXPECT_EQ(key_of(events[1]), (KeyboardEvent{L'A', KeyboardEvent::SHIFT}));
+  EXPECT_EQ(key_of(events[2]), KeyboardEvent{KeyboardKey::UP});
+  EXPECT_EQ(key_of(events[3]), KeyboardEvent{L'a'});
+  EXPECT_TRUE(key_of(events[3]).released());
+}
+
+TEST(InputParserTest, SkipsOutOfRangeKittyKeys) {
+  InputParser parser;
+  const auto events =
+      parse_chunks(parser, {"\x1B[99999999999u", "\x1B[1114112u",
+                            "\x1B[97;99999999999u", "x"});
+
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(key_of(events[0]), KeyboardEvent{L'x'});
+}
@@ -20,6 +20,7 @@
 #include "base/debug/tracing.hpp"
 #include "base/map_util.hpp"
 
+#include <algorithm>
 #include <optional>
 #include <sstream>
 #include <unordered_map>
@@ -45,11 +46,11 @@ class Renderer {
 
       do {
         if (LIKELY(position_)) {
-          if (auto [ci, cj] = position_.value(); ci == i) {  // we are on the same row
+          // Cells are added with increasing i or j within a priority band, but the next
+          // band may start anywhere, so only use CUF when moving forward.
+          if (auto [ci, cj] = position_.value(); ci == i && cj < j) {
             // use CUF
             auto distance = j - cj;
-            // For now we know, that cells are added only with increasing i or j.
-            ASSERT(distance >= 2);
             output_ << CSI;
             if (distance > 2)
               output_ << distance - 1;
@@ -61,7 +62,8 @@ class Renderer {
         output_ << CSI << i + 1 << ';' << j + 1 << 'H';
       } while (false);
     }
-    position_ = std::pair{i, j};
+    // Wide glyphs move the cursor by two columns, keep track of the last covered one.
+    position_ = std::pair{i, j + cell.width() - 1};
 
     bool empty_contents = false;
     do {  // Handle mode
@@ -118,6 +120,12 @@ class Renderer {
     }
   }
 
+  // Number of bytes this renderer is going to emit so far.
+  std::size_t size() {
+    return static_cast<std::size_t>(output_.tellp()) +
+           rle_state_.contents.size() * rle_state_.length;
+  }
+
   void merge(Renderer&& renderer) {
     renderer.flush_rle_sequence();
 
@@ -136,12 +144,13 @@ class Renderer {
 
     auto code = output_.str();
     if (code == CSI "H") {
-      LOG() << "Nothing to render";
+      LOG(RENDER, VERBOSE) << "Nothing to render";
       return;
     }
 
-    LOG() << "Render sequence: " << ::avada::internal::escape_for_log(code);
-    LOG() << "Render sequence length: " << code.size();
+    LOG(RENDER, VERBOSE) << "Render sequence: "
+                         << ::avada::internal::escape_for_log(code);
+    LOG(RENDER, VERBOSE) << "Render sequence length: " << code.size();
     internal::write_stdout(code);
   }
 
@@ -235,10 +244,28 @@ class Renderer {
   const TerminalCapabilities* capabilities_;
 };
 
+struct Damage {
+  int place;
+  int priority;
+  // Whether the screen reference is valid for the cell.
+  bool referenced;
+};
+
+int priority_of(const RenderOptions& options, int i, int j) noexcept {
+  std::optional<int> priority;
+  for (const auto& area : options.priorities) {
+    if (i >= area.top && i <= area.bottom && j >= area.left && j <= area.right)
+      priority = std::max(priority.value_or(area.priority), area.priority);
+  }
+  return priority.value_or(0);
+}
+
 }  // namespace
- 
-void render(Buffer& buffer, Buffer& screen_reference, 
-            const TerminalCapabilities& capabilities) {
+
+bool render(Buffer& buffer,
+            Buffer& screen_reference,
+            const TerminalCapabilities& capabilities,
+            const RenderOptions& options) {
   base::debug::ScopedTrace trace{"Buffer::render"};
 
   std::unordered_map<std::pair<Color, Color>, Renderer> renderers;
@@ -274,6 +301,9 @@ void render(Buffer& buffer, Buffer& screen_reference,
     columns_with_reference = screen_columns;
   }
 
+  // Collect the damage first, the cells are committed only when actually rendered.
+  std::vector<Damage> damage;
+
   int place = 0;
   auto a_b_limit = columns * rows_with_reference;
   while (place < a_b_limit) {
@@ -281,53 +311,95 @@ void render(Buffer& buffer, Buffer& screen_reference,
     auto a_limit = row_start + columns_with_reference;
     while (place < a_limit) {  // Zone "A"
       if (auto& cell = buffer.contents_[place]; cell.dirty()) {
-        cell.clear_dirty();
-        auto& ref_cell = screen_reference.contents_[place];
-        if (ref_cell == cell) {
+        if (screen_reference.contents_[place] == cell) {
           // cell passed screen reference validation, no need to redraw.
-          ++place;
-          continue;
+          cell.clear_dirty();
+        } else {
+          damage.push_back(Damage{place, 0, true});
         }
-        const auto i = place / columns;
-        const auto j = place % columns;
-        base::get_or_default(renderers, std::pair{cell.fg_color(), cell.bg_color()},
-                             default_renderer_provider).add(i, j, cell);
-        ref_cell = cell;
       }
       ++place;
     }
 
     auto row_limit = row_start + columns;
     while (place < row_limit) {  // Zone "B"
-      auto& cell =  buffer.contents_[place];
-      cell.clear_dirty();
-      const auto i = place / columns;
-      const auto j = place % columns;
-      base::get_or_default(renderers, std::pair{cell.fg_color(), cell.bg_color()},
-                           default_renderer_provider).add(i, j, cell);
-      screen_reference.contents_[place] = cell;
-      ++place;
+      damage.push_back(Damage{place++, 0, false});
     }
   }
 
   const auto limit = rows * columns;
-  while (place < limit) {
-    auto& cell =  buffer.contents_[place];
-    cell.clear_dirty();
-    const auto i = place / columns;
-    const auto j = place % columns;
-    base::get_or_default(renderers, std::pair{cell.fg_color(), cell.bg_color()},
-                         default_renderer_provider).add(i, j, cell);
-    screen_reference.contents_[place] = cell;
-    ++place;
+  while (place < limit) {  // Zone "C"
+    damage.push_back(Damage{place++, 0, false});
+  }
+
+  if (!options.priorities.empty()) {
+    for (auto& d : damage)
+      d.priority = priority_of(options, d.place / columns, d.place % columns);
+    // Stable, so the cells inside a priority band stay in the screen order.
+    std::stable_sort(damage.begin(), damage.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.priority > rhs.priority;
+    });
   }
 
   Renderer merged{capabilities};
-  LOG() << "Got " << renderers.size() << " renderers";
-  for (auto& [_, renderer] : renderers) {
-    merged.merge(std::move(renderer));
+  const auto merge_renderers = [&renderers, &merged]() {
+    LOG(RENDER, INFO) << "Got " << renderers.size() << " renderers";
+    for (auto& [_, renderer] : renderers) {
+      merged.merge(std::move(renderer));
+    }
+    renderers.clear();
+  };
+  const auto pending_size = [&renderers, &merged]() {
+    std::size_t size = merged.size();
+    for (auto& [_, renderer] : renderers)
+      size += renderer.size();
+    return size;
+  };
+
+  bool complete = true;
+  int current_row = -1;
+  std::optional<int> current_priority;
+  for (auto d = damage.begin(); d != damage.end(); ++d) {
+    const auto i = d->place / columns;
+    const auto j = d->place % columns;
+
+    if (current_priority != d->priority) {
+      // Renderers are grouped by colors, merge them per priority band to keep the order
+      // of bands in the output.
+      merge_renderers();
+      current_priority = d->priority;
+      current_row = -1;
+    }
+
+    if (options.byte_budget > 0 && i != current_row) {
+      if (pending_size() >= options.byte_budget) {
+        // Carry the rest of the damage over to the next frame.
+        for (; d != damage.end(); ++d) {
+          buffer.contents_[d->place].mark_dirty();
+          if (!d->referenced)
+            screen_reference.contents_[d->place].mark_unknown();
+        }
+        complete = false;
+        break;
+      }
+      current_row = i;
+    }
+
+    auto& cell = buffer.contents_[d->place];
+    cell.clear_dirty();
+    if (!cell.continuation()) {
+      // Continuation cells are drawn by the terminal along with their wide glyphs.
+      base::get_or_default(renderers, std::pair{cell.fg_color(), cell.bg_color()},
+                           default_renderer_provider).add(i, j, cell);
+    }
+    screen_reference.contents_[d->place] = cell;
   }
+
+  merge_renderers();
   merged.do_render();
+  if (!complete)
+    LOG(RENDER, WARNING) << "Render budget exceeded, damage is carried over";
+  return complete;
 }
 
 }  // namespace avada::render
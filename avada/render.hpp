@@ -17,12 +17,37 @@
 
 #include "avada/buffer.hpp"
 
+#include <cstddef>
+#include <vector>
+
 namespace avada::render {
 
 struct TerminalCapabilities {
   bool REP_supported;
 };
 
-void render(Buffer& buffer, Buffer& screen_reference, const TerminalCapabilities&);
+// A rectangular screen area (bounds are inclusive) with a render priority.
+// Cells not covered by any area have priority 0; overlapping areas resolve to the
+// highest priority among them.
+struct RenderPriorityArea {
+  int top, left, bottom, right;
+  int priority;
+};
+
+struct RenderOptions {
+  // Soft limit for the bytes emitted per frame, `0` means unlimited. The limit is
+  // checked on row boundaries, so a frame may exceed it by at most a single row.
+  std::size_t byte_budget = 0;
+
+  // Damaged cells are emitted in the descending order of their priorities.
+  std::vector<RenderPriorityArea> priorities;
+};
+
+// Returns `true` if all the damage has been rendered and `false` if some of it was
+// carried over to the next frame due to the byte budget.
+AVADA_PUBLIC bool render(Buffer& buffer,
+                         Buffer& screen_reference,
+                         const TerminalCapabilities&,
+                         const RenderOptions& options = {});
 
 }
\ No newline at end of file
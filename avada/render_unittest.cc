@@ -0,0 +1,117 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avada/render.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace avada::render;
+
+namespace {
+
+constexpr int kRows = 10;
+constexpr int kColumns = 20;
+
+Buffer filled_buffer() {
+  Buffer buffer{kRows, kColumns};
+  for (int i = 0; i < kRows; ++i) {
+    for (int j = 0; j < kColumns; ++j)
+      buffer(i, j).set_data(static_cast<char>('a' + (i + j) % 26));
+  }
+  return buffer;
+}
+
+bool row_dirty(const Buffer& buffer, int i) {
+  for (int j = 0; j < kColumns; ++j) {
+    if (buffer(i, j).dirty())
+      return true;
+  }
+  return false;
+}
+
+// Renders the frame and returns its output.
+std::string render_frame(Buffer& buffer,
+                         Buffer& screen,
+                         const RenderOptions& options,
+                         bool& complete) {
+  testing::internal::CaptureStdout();
+  complete = render(buffer, screen, TerminalCapabilities{}, options);
+  return testing::internal::GetCapturedStdout();
+}
+
+}  // namespace
+
+TEST(RenderTest, RendersWholeDamageWithoutBudget) {
+  auto buffer = filled_buffer();
+  Buffer screen{kRows, kColumns};
+  bool complete = false;
+  const auto output = render_frame(buffer, screen, {}, complete);
+
+  EXPECT_TRUE(complete);
+  EXPECT_NE(output.find("abcdefghijklmnopqrst"), std::string::npos);
+  for (int i = 0; i < kRows; ++i)
+    EXPECT_FALSE(row_dirty(buffer, i));
+
+  // Nothing has changed since.
+  EXPECT_EQ(render_frame(buffer, screen, {}, complete), "");
+  EXPECT_TRUE(complete);
+}
+
+TEST(RenderTest, CarriesDamageOverBudget) {
+  auto unlimited_buffer = filled_buffer();
+  Buffer unlimited_screen{kRows, kColumns};
+  bool complete = false;
+  const auto unlimited_size =
+      render_frame(unlimited_buffer, unlimited_screen, {}, complete).size();
+
+  auto buffer = filled_buffer();
+  Buffer screen{kRows, kColumns};
+  const RenderOptions options{.byte_budget = unlimited_size / 4};
+  const auto first_size = render_frame(buffer, screen, options, complete).size();
+  EXPECT_FALSE(complete);
+  EXPECT_LT(first_size, unlimited_size);
+  EXPECT_FALSE(row_dirty(buffer, 0));
+  EXPECT_TRUE(row_dirty(buffer, kRows - 1));
+
+  int frames = 1;
+  while (!complete && frames < kRows * 2) {
+    const auto size = render_frame(buffer, screen, options, complete).size();
+    // The budget is checked on row boundaries, so a single row at most goes over it.
+    EXPECT_LT(size, options.byte_budget + unlimited_size / kRows * 2);
+    ++frames;
+  }
+  EXPECT_TRUE(complete);
+  EXPECT_GT(frames, 2);
+  for (int i = 0; i < kRows; ++i)
+    EXPECT_FALSE(row_dirty(buffer, i));
+}
+
+TEST(RenderTest, RendersHigherPriorityFirst) {
+  auto buffer = filled_buffer();
+  Buffer screen{kRows, kColumns};
+  RenderOptions options;
+  options.byte_budget = 1;
+  options.priorities.push_back(RenderPriorityArea{
+      .top = kRows - 1, .left = 0, .bottom = kRows - 1, .right = kColumns - 1,
+      .priority = 1});
+  bool complete = true;
+  render_frame(buffer, screen, options, complete);
+
+  EXPECT_FALSE(complete);
+  EXPECT_FALSE(row_dirty(buffer, kRows - 1));
+  EXPECT_TRUE(row_dirty(buffer, 0));
+}
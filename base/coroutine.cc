@@ -0,0 +1,56 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/coroutine.hpp"
+
+#include "base/debug/debug.hpp"
+
+namespace base {
+
+namespace internal {
+
+void PromiseBase::resume(std::coroutine_handle<> handle) {
+  if (root->owner_alive && !root->owner_alive()) {
+    ASSERT(root->detached) << "Only spawned tasks have owners";
+    // Takes all the awaited tasks' frames along.
+    root->self.destroy();
+    return;
+  }
+  handle.resume();
+}
+
+}  // namespace internal
+
+void ResumeOn::suspend(std::coroutine_handle<> handle,
+                       internal::PromiseBase& promise) noexcept {
+  task_ = loop_.post_delayed([handle, &promise]() { promise.resume(handle); },
+                             RunLoop::duration_t::zero());
+}
+
+void Delay::suspend(std::coroutine_handle<> handle,
+                    internal::PromiseBase& promise) noexcept {
+  task_ = RunLoop::current().post_delayed(
+      [handle, &promise]() { promise.resume(handle); }, delay_);
+}
+
+void Readable::suspend(std::coroutine_handle<> handle, internal::PromiseBase& promise) {
+  watch_ = RunLoop::current().watch_fd(fd_, [this, handle, &promise]() {
+    // Fires just once; the `RunLoop` keeps the watch alive till the callback returns.
+    watch_ = nullptr;
+    promise.resume(handle);
+  });
+}
+
+}  // namespace base
@@ -0,0 +1,384 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/debug/debug.hpp"
+#include "base/macro.hpp"
+#include "base/ref_ptr.hpp"
+#include "base/run_loop.hpp"
+#include "base/thread_pool.hpp"
+#include "base/unique_function.hpp"
+#include "base/weak_ref.hpp"
+
+#include "base/config.hpp"
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// Coroutines, running on `RunLoop`s.
+//
+//   base::Task<> View::blink() {
+//     while (true) {
+//       co_await base::delay(500ms);
+//       toggle();
+//       auto text = co_await base::run_on(pool, []() { return load_text(); });
+//       set_text(text);
+//     }
+//   }
+//
+// A `Task` starts once it's awaited or `start()`ed, and is cancelled by destroying
+// it: its frame is destroyed, along with all the awaited tasks' frames and their
+// pending timers and fd watches. A `spawn()`ed task owns itself instead, and is
+// cancelled the next time it would resume after its owner is gone.
+//
+// The frames are allocated from the same pool as the big `UniqueFunction`s.
+
+namespace base {
+
+template <class T = void>
+class Task;
+
+namespace internal {
+
+struct BASE_PUBLIC PromiseBase {
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+      auto& promise = handle.promise();
+      if (promise.continuation)
+        return promise.continuation;
+      if (promise.detached)
+        handle.destroy();
+      return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  FinalAwaiter final_suspend() const noexcept { return {}; }
+
+  static void* operator new(std::size_t size) /* may throw */ {
+    return allocate_function_storage(size);
+  }
+  static void operator delete(void* ptr, std::size_t size) noexcept {
+    deallocate_function_storage(ptr, size);
+  }
+
+  // Resumes the `handle` of this suspended coroutine, unless the owner of the
+  // spawned task it runs in is gone - then destroys the spawned task instead.
+  void resume(std::coroutine_handle<> handle);
+
+  std::coroutine_handle<> self;
+  // Resumed once this one is done.
+  std::coroutine_handle<> continuation;
+  // The outermost task, the one `start()`ed or `spawn()`ed.
+  PromiseBase* root = this;
+  // Only for the spawned tasks.
+  bool detached = false;
+  UniqueFunction<bool()> owner_alive;
+};
+
+template <class Promise>
+concept TaskPromise = std::derived_from<Promise, PromiseBase>;
+
+template <class T>
+class Promise : public PromiseBase {
+ public:
+  Task<T> get_return_object() noexcept;
+
+  template <class U>
+  void return_value(U&& value) {
+    value_.emplace(std::forward<U>(value));
+  }
+
+  void unhandled_exception() {
+    if (!continuation)
+      throw;
+    exception_ = std::current_exception();
+  }
+
+  T result() {
+    if (exception_)
+      std::rethrow_exception(exception_);
+    return std::move(*value_);
+  }
+
+ private:
+  std::optional<T> value_;
+  std::exception_ptr exception_;
+};
+
+template <>
+class Promise<void> : public PromiseBase {
+ public:
+  Task<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+
+  void unhandled_exception() {
+    // Nobody to pass it to, so it goes out to the `RunLoop`.
+    if (!continuation)
+      throw;
+    exception_ = std::current_exception();
+  }
+
+  void result() {
+    if (exception_)
+      std::rethrow_exception(exception_);
+  }
+
+ private:
+  std::exception_ptr exception_;
+};
+
+}  // namespace internal
+
+template <class T>
+class Task {
+ public:
+  using promise_type = internal::Promise<T>;
+
+  Task() noexcept = default;
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~Task() noexcept { reset(); }
+
+  explicit operator bool() const noexcept { return static_cast<bool>(handle_); }
+  GETTER bool done() const noexcept { return !handle_ || handle_.done(); }
+
+  // Runs the task up to its first suspension. The task is cancelled, if this object
+  // is destroyed before the task is done.
+  void start() {
+    ASSERT(handle_ && !started_) << "Task is already started";
+    started_ = true;
+    handle_.resume();
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  template <internal::TaskPromise Promise>
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> caller) noexcept {
+    auto& promise = handle_.promise();
+    promise.continuation = caller;
+    promise.root = caller.promise().root;
+    started_ = true;
+    return handle_;
+  }
+
+  T await_resume() { return handle_.promise().result(); }
+
+ private:
+  friend class internal::Promise<T>;
+  template <class Owner>
+  friend void spawn(Task<> task, weak_ref<Owner> owner);
+  friend void spawn(Task<> task);
+
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+  void reset() noexcept {
+    if (auto handle = std::exchange(handle_, {}))
+      handle.destroy();
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+  bool started_ = false;
+};
+
+namespace internal {
+
+template <class T>
+Task<T> Promise<T>::get_return_object() noexcept {
+  auto handle = std::coroutine_handle<Promise<T>>::from_promise(*this);
+  self = handle;
+  return Task<T>{handle};
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+  auto handle = std::coroutine_handle<Promise<void>>::from_promise(*this);
+  self = handle;
+  return Task<void>{handle};
+}
+
+}  // namespace internal
+
+// Starts the task, which then destroys itself once done.
+inline void spawn(Task<> task) {
+  auto handle = std::exchange(task.handle_, {});
+  ASSERT(handle && !task.started_) << "Only a fresh task can be spawned";
+  handle.promise().detached = true;
+  handle.resume();
+}
+
+// Same, but the task is cancelled once the `owner` is gone.
+template <class Owner>
+void spawn(Task<> task, weak_ref<Owner> owner) {
+  task.handle_.promise().owner_alive = [owner = std::move(owner)]() {
+    return static_cast<bool>(owner.lock());
+  };
+  spawn(std::move(task));
+}
+
+// Awaitables, resuming the coroutine on a `RunLoop`. Destroying a suspended
+// coroutine cancels them.
+
+// Resumes the coroutine on the `loop`, which may run on another thread.
+class BASE_PUBLIC ResumeOn {
+ public:
+  explicit ResumeOn(RunLoop& loop) noexcept : loop_(loop) {}
+
+  bool await_ready() const noexcept { return false; }
+  template <internal::TaskPromise Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+    suspend(handle, handle.promise());
+  }
+  void await_resume() const noexcept {}
+
+ private:
+  void suspend(std::coroutine_handle<> handle, internal::PromiseBase& promise) noexcept;
+
+  RunLoop& loop_;
+  ref_ptr<RunLoop::DelayedTask> task_;
+};
+
+inline ResumeOn resume_on(RunLoop& loop) noexcept {
+  return ResumeOn{loop};
+}
+
+// Resumes the coroutine on the current `RunLoop` after the `delay`.
+class BASE_PUBLIC Delay {
+ public:
+  explicit Delay(RunLoop::duration_t delay) noexcept : delay_(delay) {}
+
+  bool await_ready() const noexcept { return false; }
+  template <internal::TaskPromise Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+    suspend(handle, handle.promise());
+  }
+  void await_resume() const noexcept {}
+
+ private:
+  void suspend(std::coroutine_handle<> handle, internal::PromiseBase& promise) noexcept;
+
+  const RunLoop::duration_t delay_;
+  ref_ptr<RunLoop::DelayedTask> task_;
+};
+
+inline Delay delay(RunLoop::duration_t delay) noexcept {
+  return Delay{delay};
+}
+
+// Resumes the coroutine on the current `RunLoop` once the `fd` is ready for reading.
+class BASE_PUBLIC Readable {
+ public:
+  explicit Readable(int fd) noexcept : fd_(fd) {}
+
+  bool await_ready() const noexcept { return false; }
+  template <internal::TaskPromise Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) /* may throw */ {
+    suspend(handle, handle.promise());
+  }
+  void await_resume() const noexcept {}
+
+ private:
+  void suspend(std::coroutine_handle<> handle, internal::PromiseBase& promise);
+
+  const int fd_;
+  ref_ptr<RunLoop::FdWatch> watch_;
+};
+
+inline Readable readable(int fd) noexcept {
+  return Readable{fd};
+}
+
+namespace internal {
+
+// Runs the function on the pool and resumes the coroutine with its result on the
+// current `RunLoop`.
+template <class R>
+class Offload {
+  using result_t = std::conditional_t<std::is_void_v<R>, std::monostate, R>;
+
+  struct State : public WeakReferencedThreadSafe {
+    std::optional<result_t> result;
+    std::coroutine_handle<> handle;
+    PromiseBase* promise = nullptr;
+  };
+
+ public:
+  Offload(ThreadPool& pool, UniqueFunction<R()> function) noexcept
+      : pool_(pool), function_(std::move(function)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  template <TaskPromise Promise>
+  void await_suspend(std::coroutine_handle<Promise> handle) /* may throw */ {
+    state_ = make_ref_ptr<State>();
+    state_->handle = handle;
+    state_->promise = &handle.promise();
+    // The awaiting coroutine may be gone by the time the function is done.
+    auto resume = [state = weak_ref<State>(state_)](result_t result) {
+      if (auto alive = state.lock()) {
+        alive->result.emplace(std::move(result));
+        alive->promise->resume(alive->handle);
+      }
+    };
+    if constexpr (std::is_void_v<R>) {
+      pool_.post_task_and_reply_with_result<result_t>(
+          [function = std::move(function_)]() {
+            function();
+            return result_t{};
+          },
+          std::move(resume));
+    } else {
+      pool_.post_task_and_reply_with_result<result_t>(std::move(function_),
+                                                      std::move(resume));
+    }
+  }
+
+  R await_resume() {
+    if constexpr (!std::is_void_v<R>)
+      return std::move(*state_->result);
+  }
+
+ private:
+  ThreadPool& pool_;
+  UniqueFunction<R()> function_;
+  ref_ptr<State> state_;
+};
+
+}  // namespace internal
+
+template <class F>
+auto run_on(ThreadPool& pool, F function) {
+  using R = std::invoke_result_t<F&>;
+  return internal::Offload<R>{pool, UniqueFunction<R()>(std::move(function))};
+}
+
+}  // namespace base
@@ -0,0 +1,157 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/coroutine.hpp"
+
+#include "base/debug/debug.hpp"
+#include "base/ref_ptr.hpp"
+#include "base/run_loop.hpp"
+#include "base/thread_pool.hpp"
+#include "base/weak_ref.hpp"
+#include "gtest/gtest.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Tells when the coroutine frame, holding it, is destroyed.
+struct FrameGuard {
+  bool& destroyed;
+  ~FrameGuard() { destroyed = true; }
+};
+
+struct Owner : public base::WeakReferenced {};
+
+base::Task<int> answer_later() {
+  co_await base::delay(5ms);
+  co_return 42;
+}
+
+}  // namespace
+
+class CoroutineTest : public testing::Test {
+  void SetUp() override { base::debug::setup_logging(&logger_); }
+  base::debug::LoggerToStdErr logger_;
+};
+
+TEST_F(CoroutineTest, AwaitsTasksAndDelays) {
+  base::RunLoop loop;
+  int result = 0;
+  auto coroutine = [&]() -> base::Task<> {
+    result = co_await answer_later();
+    result += co_await answer_later();
+    loop.exit_when_idle();
+  };
+
+  loop.post([&]() {
+    base::spawn(coroutine());
+    EXPECT_EQ(result, 0);
+  });
+  loop.run();
+  EXPECT_EQ(result, 84);
+}
+
+TEST_F(CoroutineTest, DestroyingTaskCancelsIt) {
+  base::RunLoop loop;
+  bool resumed = false, destroyed = false;
+  auto coroutine = [&]() -> base::Task<> {
+    FrameGuard guard{destroyed};
+    co_await base::delay(5ms);
+    resumed = true;
+  };
+
+  loop.post([&]() {
+    auto task = coroutine();
+    task.start();
+    EXPECT_FALSE(destroyed);
+    task = {};
+    EXPECT_TRUE(destroyed);
+  });
+
+  auto exit = loop.post_delayed([&]() { loop.exit_when_idle(); }, 20ms);
+  loop.run();
+  EXPECT_FALSE(resumed);
+}
+
+TEST_F(CoroutineTest, SpawnedTaskIsCancelledWithOwner) {
+  base::RunLoop loop;
+  bool resumed = false, destroyed = false;
+  auto owner = base::make_ref_ptr<Owner>();
+  auto coroutine = [&]() -> base::Task<> {
+    FrameGuard guard{destroyed};
+    co_await answer_later();
+    resumed = true;
+  };
+
+  loop.post([&]() {
+    base::spawn(coroutine(), base::weak_ref<Owner>(owner));
+    owner = nullptr;
+  });
+
+  auto exit = loop.post_delayed([&]() { loop.exit_when_idle(); }, 20ms);
+  loop.run();
+  EXPECT_FALSE(resumed);
+  EXPECT_TRUE(destroyed);
+}
+
+TEST_F(CoroutineTest, OffloadsToThreadPool) {
+  base::RunLoop loop;
+  base::ThreadPool pool{2};
+  const auto origin = std::this_thread::get_id();
+  std::thread::id worker, resumed_on;
+  std::string result;
+
+  auto coroutine = [&]() -> base::Task<> {
+    result = co_await base::run_on(pool, [&]() {
+      worker = std::this_thread::get_id();
+      return std::string("done");
+    });
+    co_await base::run_on(pool, []() {});
+    resumed_on = std::this_thread::get_id();
+    loop.exit_when_idle();
+  };
+
+  loop.post([&]() { base::spawn(coroutine()); });
+  loop.run();
+  EXPECT_EQ(result, "done");
+  EXPECT_NE(worker, origin);
+  EXPECT_EQ(resumed_on, origin);
+}
+
+TEST_F(CoroutineTest, AwaitsReadableFd) {
+  base::RunLoop loop;
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  char received = 0;
+
+  auto coroutine = [&]() -> base::Task<> {
+    co_await base::readable(fds[0]);
+    EXPECT_EQ(read(fds[0], &received, 1), 1);
+    loop.exit_when_idle();
+  };
+
+  loop.post([&]() { base::spawn(coroutine()); });
+  auto write_later = loop.post_delayed([&]() { EXPECT_EQ(write(fds[1], "x", 1), 1); }, 5ms);
+  loop.run();
+  EXPECT_EQ(received, 'x');
+  close(fds[0]);
+  close(fds[1]);
+}
@@ -0,0 +1,105 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/macro.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+// Min-heap (by `Compare`) with `Arity` children per node. A wider node makes the heap
+// shallower, and the children of one node share a cache line or two, so `pop` does
+// fewer cache misses than with a binary heap, at the price of more comparisons.
+template <class T, std::size_t Arity = 4, class Compare = std::less<T>>
+class DaryHeap {
+  static_assert(Arity >= 2, "Arity must be at least 2");
+
+ public:
+  DaryHeap() = default;
+  explicit DaryHeap(Compare compare) : compare_(std::move(compare)) {}
+
+  GETTER bool empty() const noexcept { return items_.empty(); }
+  GETTER std::size_t size() const noexcept { return items_.size(); }
+  GETTER const T& top() const noexcept { return items_.front(); }
+
+  void push(T item) /* may throw */ {
+    items_.push_back(std::move(item));
+    sift_up(items_.size() - 1);
+  }
+
+  void pop() noexcept {
+    if (items_.size() > 1) {
+      items_.front() = std::move(items_.back());
+      items_.pop_back();
+      sift_down(0);
+    } else {
+      items_.pop_back();
+    }
+  }
+
+  // Moves the top out and pops it.
+  T take() noexcept {
+    T item = std::move(items_.front());
+    pop();
+    return item;
+  }
+
+  void clear() noexcept { items_.clear(); }
+
+ private:
+  void sift_up(std::size_t index) noexcept {
+    T item = std::move(items_[index]);
+    while (index > 0) {
+      const auto parent = (index - 1) / Arity;
+      if (!compare_(item, items_[parent]))
+        break;
+      items_[index] = std::move(items_[parent]);
+      index = parent;
+    }
+    items_[index] = std::move(item);
+  }
+
+  void sift_down(std::size_t index) noexcept {
+    const auto size = items_.size();
+    T item = std::move(items_[index]);
+    while (true) {
+      const auto first = index * Arity + 1;
+      if (first >= size)
+        break;
+      const auto last = std::min(first + Arity, size);
+      auto best = first;
+      for (auto child = first + 1; child < last; ++child) {
+        if (compare_(items_[child], items_[best]))
+          best = child;
+      }
+      if (!compare_(items_[best], item))
+        break;
+      items_[index] = std::move(items_[best]);
+      index = best;
+    }
+    items_[index] = std::move(item);
+  }
+
+  std::vector<T> items_;
+  [[no_unique_address]] Compare compare_;
+};
+
+}  // namespace base
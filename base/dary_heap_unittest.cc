@@ -0,0 +1,56 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/dary_heap.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+TEST(DaryHeapTest, PopsInOrder) {
+  base::DaryHeap<int> heap;
+  std::mt19937 random{42};
+  std::vector<int> expected;
+  for (int i = 0; i < 1000; ++i) {
+    const int value = static_cast<int>(random() % 100);
+    heap.push(value);
+    expected.push_back(value);
+  }
+  std::sort(expected.begin(), expected.end());
+
+  std::vector<int> popped;
+  while (!heap.empty()) {
+    popped.push_back(heap.take());
+  }
+  EXPECT_EQ(popped, expected);
+}
+
+TEST(DaryHeapTest, InterleavedPushAndPop) {
+  base::DaryHeap<int, 3, std::greater<int>> heap;
+  heap.push(5);
+  heap.push(1);
+  heap.push(9);
+  EXPECT_EQ(heap.take(), 9);
+  heap.push(7);
+  heap.push(3);
+  EXPECT_EQ(heap.take(), 7);
+  EXPECT_EQ(heap.take(), 5);
+  EXPECT_EQ(heap.take(), 3);
+  EXPECT_EQ(heap.take(), 1);
+  EXPECT_TRUE(heap.empty());
+}
@@ -0,0 +1,197 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/debug/async_logger.hpp"
+
+#include "base/spsc_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <iterator>
+#include <string>
+
+namespace base::debug {
+
+namespace internal {
+
+// Messages are split into the fixed chunks, the last one is marked.
+struct LogChunk {
+  static constexpr std::size_t kTextSize = 253;
+
+  std::uint16_t size;
+  bool last;
+  char text[kTextSize];
+};
+static_assert(sizeof(LogChunk) == 256);
+
+struct LogRing {
+  static constexpr std::size_t kCapacity = 256;
+
+  SpscRing<LogChunk, kCapacity> chunks;
+  // Set once the thread exits.
+  std::atomic<bool> abandoned{false};
+  // Flusher only: the message being popped, written once its last chunk is.
+  std::string pending;
+};
+
+}  // namespace internal
+
+namespace {
+using internal::LogChunk;
+using internal::LogRing;
+
+bool g_logger_exists = false;
+std::atomic<std::uint64_t> g_dropped_messages{0};
+
+// The threads' rings, not taken by the logger yet.
+std::mutex g_new_rings_mutex;
+std::vector<std::shared_ptr<LogRing>> g_new_rings;
+
+struct ThreadLogRing {
+  ~ThreadLogRing() {
+    if (ring)
+      ring->abandoned.store(true, std::memory_order_release);
+  }
+
+  LogRing& get() {
+    if (!ring) {
+      ring = std::make_shared<LogRing>();
+      std::lock_guard lock(g_new_rings_mutex);
+      g_new_rings.push_back(ring);
+    }
+    return *ring;
+  }
+
+  std::shared_ptr<LogRing> ring;
+  // Keeps its capacity, the message is copied here first to learn its size.
+  std::string message;
+};
+thread_local ThreadLogRing tl_log_ring;
+}  // namespace
+
+AsyncLogger::AsyncLogger(const std::string& path)
+    : out_(path, std::ios::out | std::ios::app)
+    , reported_drops_(0)
+    , stopping_(false)
+    , flush_requests_(0)
+    , flushes_done_(0) {
+  ASSERT(!g_logger_exists) << "AsyncLogger already exists";
+  g_logger_exists = true;
+  g_dropped_messages.store(0, std::memory_order_relaxed);
+  flusher_ = std::thread([this]() { flush_routine(); });
+}
+
+AsyncLogger::~AsyncLogger() noexcept {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  wake_up_.notify_one();
+  flusher_.join();
+  drain();
+  // The next logger picks up the threads, which are still alive.
+  std::lock_guard lock(g_new_rings_mutex);
+  std::move(rings_.begin(), rings_.end(), std::back_inserter(g_new_rings));
+  g_logger_exists = false;
+}
+
+void AsyncLogger::log(std::streambuf* message) noexcept {
+  auto& thread_ring = tl_log_ring;
+  auto& text = thread_ring.message;
+  text.clear();
+  char part[256];
+  while (const auto size = message->sgetn(part, sizeof(part))) {
+    text.append(part, static_cast<std::size_t>(size));
+  }
+
+  auto& chunks = thread_ring.get().chunks;
+  const auto needed = std::max<std::size_t>(
+      (text.size() + LogChunk::kTextSize - 1) / LogChunk::kTextSize, 1);
+  // Only the flusher frees the space meanwhile, so the message fits for sure.
+  if (chunks.capacity() - chunks.size() < needed) {
+    g_dropped_messages.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  for (std::size_t offset = 0, left = needed; left > 0; --left) {
+    LogChunk chunk;
+    chunk.size = static_cast<std::uint16_t>(
+        std::min(text.size() - offset, LogChunk::kTextSize));
+    chunk.last = left == 1;
+    std::memcpy(chunk.text, text.data() + offset, chunk.size);
+    offset += chunk.size;
+    chunks.try_push(chunk);
+  }
+}
+
+void AsyncLogger::flush() noexcept {
+  if (std::this_thread::get_id() == flusher_.get_id()) {
+    drain();
+    return;
+  }
+  std::unique_lock lock(mutex_);
+  const auto request = ++flush_requests_;
+  wake_up_.notify_one();
+  flushed_.wait(lock,
+                [this, request]() { return flushes_done_ >= request || stopping_; });
+}
+
+std::size_t AsyncLogger::dropped_messages() const noexcept {
+  return g_dropped_messages.load(std::memory_order_relaxed);
+}
+
+void AsyncLogger::flush_routine() noexcept {
+  std::unique_lock lock(mutex_);
+  while (!stopping_) {
+    wake_up_.wait_for(lock, kFlushInterval, [this]() {
+      return stopping_ || flush_requests_ > flushes_done_;
+    });
+    const auto requests = flush_requests_;
+    lock.unlock();
+    drain();
+    lock.lock();
+    flushes_done_ = requests;
+    flushed_.notify_all();
+  }
+}
+
+void AsyncLogger::drain() noexcept {
+  {
+    std::lock_guard lock(g_new_rings_mutex);
+    std::move(g_new_rings.begin(), g_new_rings.end(), std::back_inserter(rings_));
+    g_new_rings.clear();
+  }
+  std::erase_if(rings_, [this](const auto& ring) {
+    const bool abandoned = ring->abandoned.load(std::memory_order_acquire);
+    while (auto chunk = ring->chunks.try_pop()) {
+      ring->pending.append(chunk->text, chunk->size);
+      if (chunk->last) {
+        out_ << ring->pending << '\n';
+        ring->pending.clear();
+      }
+    }
+    return abandoned;
+  });
+  const auto drops = g_dropped_messages.load(std::memory_order_relaxed);
+  if (drops != reported_drops_) {
+    out_ << "[AsyncLogger: " << drops - reported_drops_ << " messages dropped]\n";
+    reported_drops_ = drops;
+  }
+  out_.flush();
+}
+
+}  // namespace base::debug
@@ -0,0 +1,77 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/debug/debug.hpp"
+#include "base/macro.hpp"
+
+#include "base/config.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace base::debug {
+
+namespace internal {
+struct LogRing;
+}  // namespace internal
+
+// Logger, which doesn't block the logging threads on IO: each thread copies its
+// messages into its own preallocated lock-free ring, and a background thread writes
+// them to the file in batches. A message, which doesn't fit into the thread's ring,
+// is dropped; the drops are reported in the log. Only one may exist at a time.
+class BASE_PUBLIC AsyncLogger final : public LoggerBase {
+ public:
+  explicit AsyncLogger(const std::string& path) /* may throw */;
+  ~AsyncLogger() noexcept;
+
+  DISABLE_COPY_MOVE(AsyncLogger);
+
+  void log(std::streambuf* message) noexcept override;
+  // Blocks until the messages, logged before, are written.
+  void flush() noexcept override;
+
+  GETTER std::size_t dropped_messages() const noexcept;
+
+ private:
+  static constexpr std::chrono::milliseconds kFlushInterval{50};
+
+  void flush_routine() noexcept;
+  // Flusher thread only, or after it's stopped.
+  void drain() noexcept;
+
+  std::ofstream out_;
+  // Drained rings of the exited threads are dropped.
+  std::vector<std::shared_ptr<internal::LogRing>> rings_;
+  std::uint64_t reported_drops_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_up_;
+  std::condition_variable flushed_;
+  bool stopping_;
+  std::uint64_t flush_requests_;
+  std::uint64_t flushes_done_;
+  std::thread flusher_;
+};
+
+}  // namespace base::debug
@@ -0,0 +1,92 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/debug/async_logger.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::string read_file(const std::string& path) {
+  std::ifstream in(path);
+  return {std::istreambuf_iterator<char>(in), {}};
+}
+
+std::size_t count(const std::string& text, const std::string& what) {
+  std::size_t result = 0;
+  for (auto pos = text.find(what); pos != std::string::npos;
+       pos = text.find(what, pos + 1)) {
+    ++result;
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(AsyncLoggerTest, WritesMessagesOfAllThreads) {
+  const std::string path = ::testing::TempDir() + "async_logger_unittest.log";
+  std::remove(path.c_str());
+  const std::string long_text(1000, 'x');
+  {
+    base::debug::AsyncLogger logger(path);
+    base::debug::setup_logging(&logger);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([i]() {
+        for (int j = 0; j < 10; ++j)
+          LOG() << "message " << i << ":" << j;
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    LOG() << long_text;
+    logger.flush();
+    base::debug::setup_logging(nullptr);
+
+    const auto log = read_file(path);
+    EXPECT_EQ(count(log, "message "), 40u);
+    EXPECT_NE(log.find("message 3:9\n"), std::string::npos);
+    EXPECT_NE(log.find(long_text + "\n"), std::string::npos);
+    EXPECT_EQ(logger.dropped_messages(), 0u);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(AsyncLoggerTest, DropsMessagesWhichDontFit) {
+  const std::string path = ::testing::TempDir() + "async_logger_unittest_drops.log";
+  std::remove(path.c_str());
+  {
+    base::debug::AsyncLogger logger(path);
+    // Doesn't fit into the thread's ring at all.
+    std::stringbuf huge(std::string(1 << 20, 'x'));
+    logger.log(&huge);
+    std::stringbuf small("small");
+    logger.log(&small);
+    logger.flush();
+    EXPECT_EQ(logger.dropped_messages(), 1u);
+  }
+  const auto log = read_file(path);
+  EXPECT_NE(log.find("small\n"), std::string::npos);
+  EXPECT_NE(log.find("[AsyncLogger: 1 messages dropped]"), std::string::npos);
+  std::remove(path.c_str());
+}
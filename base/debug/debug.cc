@@ -17,10 +17,18 @@
 
 #include "base/debug/stack_trace.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <codecvt>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <locale>
+#include <vector>
 
 namespace base::debug {
 
@@ -31,28 +39,174 @@ LoggerBase* volatile g_logger;
 
 }  // namespace
 
+namespace internal {
+std::atomic<std::uint32_t> g_enabled_log_categories{~std::uint32_t{0}};
+}  // namespace internal
+
 void setup_logging(LoggerBase* logger) noexcept {
   g_logger = logger;
 }
 
+void set_log_category_enabled(LogCategory category, bool enabled) noexcept {
+  const auto bit = std::uint32_t{1} << static_cast<int>(category);
+  if (enabled)
+    internal::g_enabled_log_categories.fetch_or(bit, std::memory_order_relaxed);
+  else
+    internal::g_enabled_log_categories.fetch_and(~bit, std::memory_order_relaxed);
+}
+
+bool enable_only_log_categories(std::string_view names) noexcept {
+  std::uint32_t enabled = 0;
+  while (!names.empty()) {
+    const auto comma = names.find(',');
+    const auto category = log_category_from_name(names.substr(0, comma));
+    if (!category)
+      return false;
+    enabled |= std::uint32_t{1} << static_cast<int>(*category);
+    names.remove_prefix(comma == std::string_view::npos ? names.size() : comma + 1);
+  }
+  internal::g_enabled_log_categories.store(enabled, std::memory_order_relaxed);
+  return true;
+}
+
+std::optional<LogCategory> log_category_from_name(std::string_view name) noexcept {
+  for (auto category : {LogCategory::GENERAL, LogCategory::RENDER, LogCategory::INPUT,
+                        LogCategory::LAYOUT, LogCategory::PAINT, LogCategory::RUNLOOP}) {
+    if (name == to_string(category))
+      return category;
+  }
+  return std::nullopt;
+}
+
+const char* to_string(LogCategory category) noexcept {
+  switch (category) {
+    case LogCategory::GENERAL:
+      return "general";
+    case LogCategory::RENDER:
+      return "render";
+    case LogCategory::INPUT:
+      return "input";
+    case LogCategory::LAYOUT:
+      return "layout";
+    case LogCategory::PAINT:
+      return "paint";
+    case LogCategory::RUNLOOP:
+      return "runloop";
+  }
+  return "unknown";
+}
+
+const char* to_string(LogLevel level) noexcept {
+  switch (level) {
+    case LogLevel::VERBOSE:
+      return "verbose";
+    case LogLevel::INFO:
+      return "info";
+    case LogLevel::WARNING:
+      return "warning";
+    case LogLevel::ERROR:
+      return "error";
+  }
+  return "unknown";
+}
+
 void LoggerToStdErr::log(std::streambuf* message) noexcept {
   std::cerr << message << std::endl;
 }
 
 namespace internal {
 
+// Writes into a string, which keeps its capacity when the buffer is reset.
+class LogBuffer final : public std::streambuf {
+ public:
+  void reset() noexcept {
+    setp(data_.data(), data_.data() + data_.size());
+    setg(nullptr, nullptr, nullptr);
+  }
+
+  // Makes the written message readable.
+  void seal() noexcept { setg(pbase(), pbase(), pptr()); }
+
+ protected:
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      return traits_type::not_eof(c);
+    const auto written = pptr() - pbase();
+    data_.resize(std::max<std::size_t>(data_.size() * 2, 256));
+    setp(data_.data(), data_.data() + data_.size());
+    pbump(static_cast<int>(written));
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+    return c;
+  }
+
+ private:
+  std::string data_;
+};
+
+struct LogStream {
+  LogStream() : stream(&buffer) {}
+
+  // As if the stream was just created.
+  void reset() noexcept {
+    buffer.reset();
+    stream.clear();
+    stream.flags(std::ios_base::skipws | std::ios_base::dec);
+    stream.precision(6);
+    stream.width(0);
+    stream.fill(' ');
+  }
+
+  LogBuffer buffer;
+  std::ostream stream;
+};
+
+namespace {
+// A message may be logged while the arguments of another one are formatted, so
+// there's a stream per nesting level.
+struct ThreadLogStreams {
+  std::vector<std::unique_ptr<LogStream>> streams;
+  std::size_t depth = 0;
+};
+thread_local ThreadLogStreams tl_log_streams;
+}  // namespace
+
 LoggerProxy::LoggerProxy(const char* file, int line, bool terminate) noexcept
-    : terminate_after_(terminate), ss_(std::ios::in | std::ios::out) {
-  ss_ << file << ':' << line << " [thread:" << std::this_thread::get_id() << "] ";
+    : terminate_after_(terminate) {
+  auto& streams = tl_log_streams;
+  if (streams.depth == streams.streams.size())
+    streams.streams.push_back(std::make_unique<LogStream>());
+  stream_ = streams.streams[streams.depth++].get();
+  stream_->reset();
+  stream_->stream << file << ':' << line << " [thread:" << std::this_thread::get_id()
+                  << "] ";
+}
+
+LoggerProxy::LoggerProxy(const char* file,
+                         int line,
+                         LogCategory category,
+                         LogLevel level) noexcept
+    : LoggerProxy(file, line) {
+  if (category != LogCategory::GENERAL || level != LogLevel::INFO)
+    stream_->stream << '[' << to_string(category) << ':' << to_string(level) << "] ";
 }
 
 LoggerProxy::~LoggerProxy() noexcept {
   if (terminate_after_)
-    ss_ << '\n' << StackTrace().to_string("Terminating");
+    stream_->stream << '\n' << StackTrace().to_string("Terminating");
+  stream_->buffer.seal();
   if (g_logger)
-    g_logger->log(ss_.rdbuf());
-  if (terminate_after_)
+    g_logger->log(&stream_->buffer);
+  --tl_log_streams.depth;
+  if (terminate_after_) {
+    if (g_logger)
+      g_logger->flush();
     std::abort();
+  }
+}
+
+std::ostream& LoggerProxy::stream() noexcept {
+  return stream_->stream;
 }
 
 }  // namespace internal
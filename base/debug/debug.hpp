@@ -19,7 +19,11 @@
 
 #include "base/config.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <optional>
 #include <sstream>
+#include <string_view>
 
 #if !defined(NDEBUG)
 #define ENABLE_LOG 1
@@ -27,10 +31,45 @@
 #define ENABLE_ASSERTS 1
 #else
 #define ENABLE_LOG 0
-#define ENABLE_TRACE 1
+#define ENABLE_TRACE 0
 #define ENABLE_ASSERTS 0
 #endif  // !defined(NDEBUG)
 
+#define LOG_LEVEL_VERBOSE 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_NONE 4
+
+// The messages below the minimal level are not compiled in. It may be overridden for
+// the whole build or per category, e.g. `-DLOG_MIN_LEVEL_RENDER=LOG_LEVEL_VERBOSE`.
+#ifndef LOG_MIN_LEVEL
+#if ENABLE_LOG
+#define LOG_MIN_LEVEL LOG_LEVEL_VERBOSE
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_NONE
+#endif  // ENABLE_LOG
+#endif  // LOG_MIN_LEVEL
+
+#ifndef LOG_MIN_LEVEL_GENERAL
+#define LOG_MIN_LEVEL_GENERAL LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_RENDER
+#define LOG_MIN_LEVEL_RENDER LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_INPUT
+#define LOG_MIN_LEVEL_INPUT LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_LAYOUT
+#define LOG_MIN_LEVEL_LAYOUT LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_PAINT
+#define LOG_MIN_LEVEL_PAINT LOG_MIN_LEVEL
+#endif
+#ifndef LOG_MIN_LEVEL_RUNLOOP
+#define LOG_MIN_LEVEL_RUNLOOP LOG_MIN_LEVEL
+#endif
+
 #define CONDITIONAL_LOG_STREAM(condition, stream) \
   !(condition) ? (void)0 : ::base::debug::internal::LogStarterDummy() & (stream)
 
@@ -38,7 +77,20 @@
   CONDITIONAL_LOG_STREAM( \
       ENABLE_##kind, ::base::debug::internal::LoggerProxy(__FILE__, __LINE__).stream())
 
-#define LOG() LOG_IMPL(LOG)
+// The level is checked at compile time, and the category's runtime flag is checked
+// before anything is formatted.
+#define LOG_AT(category, level, ...)                                                 \
+  CONDITIONAL_LOG_STREAM(                                                            \
+      LOG_LEVEL_##level >= LOG_MIN_LEVEL_##category &&                               \
+          ::base::debug::log_category_enabled(::base::debug::LogCategory::category), \
+      ::base::debug::internal::LoggerProxy(__FILE__, __LINE__,                       \
+                                           ::base::debug::LogCategory::category,     \
+                                           ::base::debug::LogLevel::level)           \
+          .stream())
+
+// `LOG()` is an info message of the general category, `LOG(RENDER, VERBOSE)` sets
+// them explicitly.
+#define LOG(...) LOG_AT(__VA_OPT__(__VA_ARGS__, ) GENERAL, INFO)
 #define TRACE() LOG_IMPL(TRACE)
 
 #define ASSERT(condition)                                                     \
@@ -49,9 +101,48 @@
 
 namespace base::debug {
 
+enum class LogLevel {
+  VERBOSE = LOG_LEVEL_VERBOSE,
+  INFO = LOG_LEVEL_INFO,
+  WARNING = LOG_LEVEL_WARNING,
+  ERROR = LOG_LEVEL_ERROR,
+};
+
+enum class LogCategory {
+  GENERAL,
+  RENDER,
+  INPUT,
+  LAYOUT,
+  PAINT,
+  RUNLOOP,
+};
+
+namespace internal {
+// Bit per `LogCategory`, all are enabled by default.
+BASE_PUBLIC extern std::atomic<std::uint32_t> g_enabled_log_categories;
+}  // namespace internal
+
+inline bool log_category_enabled(LogCategory category) noexcept {
+  return internal::g_enabled_log_categories.load(std::memory_order_relaxed) &
+         (std::uint32_t{1} << static_cast<int>(category));
+}
+
+BASE_PUBLIC void set_log_category_enabled(LogCategory category, bool enabled) noexcept;
+
+// Enables only the listed categories, e.g. "render,input". Returns false, if some name
+// is unknown, and leaves the categories as they were then.
+BASE_PUBLIC bool enable_only_log_categories(std::string_view names) noexcept;
+
+GETTER BASE_PUBLIC std::optional<LogCategory> log_category_from_name(
+    std::string_view name) noexcept;
+GETTER BASE_PUBLIC const char* to_string(LogCategory category) noexcept;
+GETTER BASE_PUBLIC const char* to_string(LogLevel level) noexcept;
+
 class BASE_PUBLIC LoggerBase {
  public:
   virtual void log(std::streambuf* message) noexcept = 0;
+  // Called before terminating on a failed assertion.
+  virtual void flush() noexcept {}
 
  protected:
   ~LoggerBase() noexcept = default;
@@ -67,19 +158,24 @@ BASE_PUBLIC void setup_logging(LoggerBase* logger) noexcept;
 
 namespace internal {
 
+struct LogStream;
+
 class BASE_PUBLIC LoggerProxy {
  public:
   LoggerProxy(const char* file, int line, bool terminate = false) noexcept;
+  LoggerProxy(const char* file, int line, LogCategory category, LogLevel level) noexcept;
 
   ~LoggerProxy() noexcept;
 
   DISABLE_COPY_MOVE(LoggerProxy);
 
-  std::ostream& stream() { return ss_; }
+  std::ostream& stream() noexcept;
 
  private:
   bool terminate_after_;
-  std::stringstream ss_;
+  // Owned by the thread and reused by its next messages, so logging doesn't allocate
+  // in the steady state.
+  LogStream* stream_;
 };
 
 struct LogStarterDummy {
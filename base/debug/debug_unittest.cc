@@ -0,0 +1,98 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Regardless of the build type; but the paint messages below warnings are compiled out.
+#define LOG_MIN_LEVEL LOG_LEVEL_VERBOSE
+#define LOG_MIN_LEVEL_PAINT LOG_LEVEL_WARNING
+
+#include "base/debug/debug.hpp"
+
+#include "gtest/gtest.h"
+
+#include <iterator>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+class CollectingLogger final : public base::debug::LoggerBase {
+ public:
+  void log(std::streambuf* message) noexcept override {
+    messages.emplace_back(std::istreambuf_iterator<char>(message),
+                          std::istreambuf_iterator<char>());
+  }
+
+  std::vector<std::string> messages;
+};
+
+int formatted(int& counter) {
+  return ++counter;
+}
+
+class LogCategoriesTest : public testing::Test {
+ protected:
+  void SetUp() override { base::debug::setup_logging(&logger_); }
+  void TearDown() override {
+    base::debug::setup_logging(nullptr);
+    base::debug::enable_only_log_categories(
+        "general,render,input,layout,paint,runloop");
+  }
+
+  CollectingLogger logger_;
+};
+
+}  // namespace
+
+using base::debug::LogCategory;
+
+TEST_F(LogCategoriesTest, DisabledCategoryIsNotFormatted) {
+  int counter = 0;
+  base::debug::set_log_category_enabled(LogCategory::LAYOUT, false);
+  LOG(LAYOUT, INFO) << formatted(counter);
+  EXPECT_EQ(counter, 0);
+  EXPECT_TRUE(logger_.messages.empty());
+
+  base::debug::set_log_category_enabled(LogCategory::LAYOUT, true);
+  LOG(LAYOUT, INFO) << formatted(counter);
+  EXPECT_EQ(counter, 1);
+  ASSERT_EQ(logger_.messages.size(), 1u);
+  EXPECT_NE(logger_.messages[0].find("[layout:info] 1"), std::string::npos);
+}
+
+TEST_F(LogCategoriesTest, LevelsBelowMinimumAreCompiledOut) {
+  int counter = 0;
+  LOG(PAINT, VERBOSE) << formatted(counter);
+  LOG(PAINT, INFO) << formatted(counter);
+  EXPECT_EQ(counter, 0);
+  LOG(PAINT, ERROR) << formatted(counter);
+  EXPECT_EQ(counter, 1);
+  EXPECT_EQ(logger_.messages.size(), 1u);
+}
+
+TEST_F(LogCategoriesTest, EnablesOnlyListedCategories) {
+  EXPECT_TRUE(base::debug::enable_only_log_categories("render,input"));
+  EXPECT_TRUE(base::debug::log_category_enabled(LogCategory::RENDER));
+  EXPECT_TRUE(base::debug::log_category_enabled(LogCategory::INPUT));
+  EXPECT_FALSE(base::debug::log_category_enabled(LogCategory::GENERAL));
+  EXPECT_FALSE(base::debug::log_category_enabled(LogCategory::RUNLOOP));
+
+  EXPECT_FALSE(base::debug::enable_only_log_categories("render,bogus"));
+  EXPECT_TRUE(base::debug::log_category_enabled(LogCategory::RENDER));
+  EXPECT_FALSE(base::debug::log_category_enabled(LogCategory::GENERAL));
+
+  LOG() << "skipped";
+  EXPECT_TRUE(logger_.messages.empty());
+}
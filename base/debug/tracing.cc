@@ -16,17 +16,173 @@
 #include "base/debug/tracing.hpp"
 
 #include "base/debug/debug.hpp"
+#include "base/spsc_ring.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <ios>
 
 namespace base::debug {
 
+namespace internal {
+
+// Fits half a cache line.
+struct TraceEvent {
+  const char* name;
+  std::uint32_t name_size;
+  std::int64_t start_ns;
+  std::int64_t duration_ns;
+};
+
+struct TraceBuffer {
+  static constexpr std::size_t kCapacity = 16 * 1024;
+
+  explicit TraceBuffer(std::uint32_t thread_id) noexcept : thread_id(thread_id) {}
+
+  const std::uint32_t thread_id;
+  SpscRing<TraceEvent, kCapacity> events;
+  // Set once the thread exits.
+  std::atomic<bool> abandoned{false};
+};
+
+}  // namespace internal
+
+namespace {
+using internal::TraceBuffer;
+using internal::TraceEvent;
+
+std::atomic<bool> g_recording{false};
+std::atomic<std::uint32_t> g_next_thread_id{1};
+std::atomic<std::size_t> g_dropped_events{0};
+
+// The threads' buffers, not taken by the recorder yet.
+std::mutex g_new_buffers_mutex;
+std::vector<std::shared_ptr<TraceBuffer>> g_new_buffers;
+
+struct ThreadTraceBuffer {
+  ~ThreadTraceBuffer() {
+    if (buffer)
+      buffer->abandoned.store(true, std::memory_order_release);
+  }
+
+  TraceBuffer& get() {
+    if (!buffer) {
+      buffer = std::make_shared<TraceBuffer>(
+          g_next_thread_id.fetch_add(1, std::memory_order_relaxed));
+      std::lock_guard lock(g_new_buffers_mutex);
+      g_new_buffers.push_back(buffer);
+    }
+    return *buffer;
+  }
+
+  std::shared_ptr<TraceBuffer> buffer;
+};
+thread_local ThreadTraceBuffer tl_trace_buffer;
+
+std::int64_t to_ns(std::chrono::steady_clock::duration duration) noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+void write_json_string(std::ostream& out, std::string_view string) {
+  out << '"';
+  for (const char c : string) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+}  // namespace
+
+TraceRecorder::TraceRecorder(const std::string& path)
+    : out_(path, std::ios::out | std::ios::trunc), first_event_(true), stopping_(false) {
+  ASSERT(!g_recording.load(std::memory_order_relaxed)) << "TraceRecorder already exists";
+  out_ << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  g_dropped_events.store(0, std::memory_order_relaxed);
+  g_recording.store(true, std::memory_order_release);
+  flusher_ = std::thread([this]() { flush_routine(); });
+}
+
+TraceRecorder::~TraceRecorder() noexcept {
+  g_recording.store(false, std::memory_order_relaxed);
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  stop_condition_.notify_one();
+  flusher_.join();
+  // The scopes, which have started before, still may be ending, they're lost.
+  drain();
+  out_ << "\n]}\n";
+  // The next recorder picks up the threads, which are still alive.
+  std::lock_guard lock(g_new_buffers_mutex);
+  std::move(buffers_.begin(), buffers_.end(), std::back_inserter(g_new_buffers));
+}
+
+bool TraceRecorder::active() noexcept {
+  return g_recording.load(std::memory_order_relaxed);
+}
+
+std::size_t TraceRecorder::dropped_events() const noexcept {
+  return g_dropped_events.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::flush_routine() noexcept {
+  std::unique_lock lock(mutex_);
+  const auto stopping = [this]() { return stopping_; };
+  while (!stop_condition_.wait_for(lock, kFlushInterval, stopping)) {
+    lock.unlock();
+    drain();
+    lock.lock();
+  }
+}
+
+void TraceRecorder::drain() noexcept {
+  {
+    std::lock_guard lock(g_new_buffers_mutex);
+    std::move(g_new_buffers.begin(), g_new_buffers.end(), std::back_inserter(buffers_));
+    g_new_buffers.clear();
+  }
+  std::erase_if(buffers_, [this](const auto& buffer) {
+    const bool abandoned = buffer->abandoned.load(std::memory_order_acquire);
+    while (auto event = buffer->events.try_pop()) {
+      out_ << (first_event_ ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":1,\"tid\":"
+           << buffer->thread_id << ",\"name\":";
+      write_json_string(out_, {event->name, event->name_size});
+      // Since the steady clock's epoch, the viewers only need the deltas.
+      out_ << ",\"ts\":" << event->start_ns / 1000 << '.' << event->start_ns % 1000 / 100
+           << ",\"dur\":" << event->duration_ns / 1000 << '.'
+           << event->duration_ns % 1000 / 100 << '}';
+      first_event_ = false;
+    }
+    return abandoned;
+  });
+  out_.flush();
+}
+
 ScopedTrace::ScopedTrace(std::string_view name) noexcept
-    : name_{name}, start_{std::chrono::high_resolution_clock::now()} {}
+    : name_{name}, recording_{TraceRecorder::active()} {
+  if (recording_ || ENABLE_TRACE) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
 
 ScopedTrace::~ScopedTrace() noexcept {
-  using namespace std::chrono;
-  auto duration = high_resolution_clock::now() - start_;
-  TRACE() << "trace (" << name_ << "): " << duration_cast<microseconds>(duration).count()
-          << L" μs";
+  if (recording_) {
+    const auto end = std::chrono::steady_clock::now();
+    auto& buffer = tl_trace_buffer.get();
+    const TraceEvent event{name_.data(), static_cast<std::uint32_t>(name_.size()),
+                           to_ns(start_.time_since_epoch()), to_ns(end - start_)};
+    if (!buffer.events.try_push(event)) {
+      g_dropped_events.fetch_add(1, std::memory_order_relaxed);
+    }
+  } else if (ENABLE_TRACE) {
+    using namespace std::chrono;
+    auto duration = steady_clock::now() - start_;
+    TRACE() << "trace (" << name_ << "): "
+            << duration_cast<microseconds>(duration).count() << L" μs";
+  }
 }
 
 }  // namespace base::debug
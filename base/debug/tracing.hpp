@@ -19,22 +19,77 @@
 
 #include "base/config.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 namespace base::debug {
 
+namespace internal {
+struct TraceBuffer;
+}  // namespace internal
+
+// Records the `ScopedTrace`s of all threads, while it exists, into a file in the Chrome
+// trace-event JSON format, which Perfetto and chrome://tracing open. Each thread
+// writes fixed-size binary events into its own lock-free ring, and a background
+// thread formats and writes them out. The events, which don't fit into a full ring,
+// are dropped. Only one recorder may exist at a time.
+class BASE_PUBLIC TraceRecorder {
+ public:
+  explicit TraceRecorder(const std::string& path) /* may throw */;
+  ~TraceRecorder() noexcept;
+
+  DISABLE_COPY_MOVE(TraceRecorder);
+
+  GETTER static bool active() noexcept;
+
+  GETTER std::size_t dropped_events() const noexcept;
+
+ private:
+  static constexpr std::chrono::milliseconds kFlushInterval{100};
+
+  void flush_routine() noexcept;
+  // Writes out the recorded events. Flusher thread only, or after it's stopped.
+  void drain() noexcept;
+
+  std::ofstream out_;
+  bool first_event_;
+  // Drained buffers of the exited threads are dropped.
+  std::vector<std::shared_ptr<internal::TraceBuffer>> buffers_;
+
+  std::mutex mutex_;
+  std::condition_variable stop_condition_;
+  bool stopping_;
+  std::thread flusher_;
+};
+
+// Measures the scope: records it, if there is a `TraceRecorder`, or logs it with
+// `TRACE()`, if that's enabled.
 class BASE_PUBLIC ScopedTrace {
  public:
-  ScopedTrace(std::string_view name) noexcept;
+  // The name is stored as a pointer and read later by the recorder's thread, so only
+  // literals are accepted.
+  template <std::size_t N>
+  ScopedTrace(const char (&name)[N]) noexcept
+      : ScopedTrace(std::string_view{name, N - 1}) {}
   ~ScopedTrace() noexcept;
 
   DISABLE_COPY_MOVE(ScopedTrace);
 
  private:
+  explicit ScopedTrace(std::string_view name) noexcept;
+
   std::string_view name_;
-  std::chrono::time_point<std::chrono::high_resolution_clock> start_;
+  bool recording_;
+  std::chrono::steady_clock::time_point start_;
 };
 
 }  // namespace base::debug
-
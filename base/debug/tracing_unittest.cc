@@ -0,0 +1,69 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/debug/tracing.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace {
+
+std::string read_file(const std::string& path) {
+  std::ifstream in(path);
+  return {std::istreambuf_iterator<char>(in), {}};
+}
+
+}  // namespace
+
+// The recorder reads the name later, so a temporary string would dangle.
+static_assert(std::is_constructible_v<base::debug::ScopedTrace, const char (&)[5]>);
+static_assert(!std::is_constructible_v<base::debug::ScopedTrace, std::string>);
+static_assert(!std::is_constructible_v<base::debug::ScopedTrace, std::string_view>);
+
+TEST(TracingTest, RecordsChromeTraceEvents) {
+  const std::string path = ::testing::TempDir() + "tracing_unittest.json";
+  EXPECT_FALSE(base::debug::TraceRecorder::active());
+  {
+    base::debug::TraceRecorder recorder(path);
+    EXPECT_TRUE(base::debug::TraceRecorder::active());
+    { base::debug::ScopedTrace trace{"main \"scope\""}; }
+    std::thread([]() { base::debug::ScopedTrace trace{"thread scope"}; }).join();
+    EXPECT_EQ(recorder.dropped_events(), 0u);
+  }
+  EXPECT_FALSE(base::debug::TraceRecorder::active());
+
+  const auto trace = read_file(path);
+  EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+  EXPECT_NE(trace.find("\"name\":\"main \\\"scope\\\"\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"thread scope\""), std::string::npos);
+  EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+  EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+  std::remove(path.c_str());
+}
+
+TEST(TracingTest, NothingIsRecordedWithoutRecorder) {
+  const std::string path = ::testing::TempDir() + "tracing_unittest_empty.json";
+  { base::debug::ScopedTrace trace{"unrecorded"}; }
+  { base::debug::TraceRecorder recorder(path); }
+
+  EXPECT_EQ(read_file(path).find("unrecorded"), std::string::npos);
+  std::remove(path.c_str());
+}
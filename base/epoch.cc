@@ -0,0 +1,190 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/epoch.hpp"
+
+#include "base/debug/debug.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace base {
+
+namespace {
+// Retiring this many objects on a thread triggers the reclamation.
+constexpr std::size_t kReclaimThreshold = 64;
+// The thread's state is its pinned epoch, shifted left by one, and the pinned bit.
+constexpr std::uint64_t kPinned = 1;
+
+struct Retired {
+  void* object;
+  void (*deleter)(void*);
+  std::uint64_t epoch;
+};
+
+// Participants are only added, and reused once their threads exit.
+struct Participant {
+  std::atomic<std::uint64_t> state{0};
+  std::atomic<bool> in_use{true};
+  Participant* next = nullptr;
+};
+
+std::atomic<std::uint64_t> g_epoch{0};
+std::atomic<Participant*> g_participants{nullptr};
+
+// Left behind by the exited threads.
+std::mutex g_orphans_mutex;
+std::vector<Retired> g_orphans;
+std::atomic<bool> g_has_orphans{false};
+
+Participant* acquire_participant() {
+  for (auto* participant = g_participants.load(std::memory_order_acquire); participant;
+       participant = participant->next) {
+    bool in_use = false;
+    if (!participant->in_use.load(std::memory_order_relaxed) &&
+        participant->in_use.compare_exchange_strong(in_use, true,
+                                                    std::memory_order_acquire)) {
+      return participant;
+    }
+  }
+  auto* participant = new Participant;
+  participant->next = g_participants.load(std::memory_order_relaxed);
+  while (!g_participants.compare_exchange_weak(participant->next, participant,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+  }
+  return participant;
+}
+
+// Advances the epoch, if every pinned thread has seen the current one.
+void try_advance() noexcept {
+  auto epoch = g_epoch.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  for (auto* participant = g_participants.load(std::memory_order_acquire); participant;
+       participant = participant->next) {
+    const auto state = participant->state.load(std::memory_order_relaxed);
+    if ((state & kPinned) && (state >> 1) != epoch)
+      return;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  g_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_release,
+                                  std::memory_order_relaxed);
+}
+
+// Deletes the objects, retired at least two epochs ago, and keeps the rest.
+void delete_expired(std::vector<Retired>& retired) noexcept {
+  const auto epoch = g_epoch.load(std::memory_order_acquire);
+  const auto kept =
+      std::partition(retired.begin(), retired.end(),
+                     [epoch](const auto& item) { return item.epoch + 2 > epoch; });
+  std::vector<Retired> expired(std::make_move_iterator(kept),
+                               std::make_move_iterator(retired.end()));
+  retired.erase(kept, retired.end());
+  // The deleters may retire more.
+  for (const auto& item : expired) {
+    item.deleter(item.object);
+  }
+}
+
+struct ThreadState {
+  ~ThreadState() {
+    ASSERT(depth == 0) << "Thread exits with a pinned epoch";
+    if (!retired.empty()) {
+      std::lock_guard lock(g_orphans_mutex);
+      std::move(retired.begin(), retired.end(), std::back_inserter(g_orphans));
+      g_has_orphans.store(true, std::memory_order_relaxed);
+    }
+    if (participant) {
+      participant->in_use.store(false, std::memory_order_release);
+    }
+  }
+
+  Participant& get_participant() {
+    if (!participant)
+      participant = acquire_participant();
+    return *participant;
+  }
+
+  Participant* participant = nullptr;
+  unsigned depth = 0;
+  std::vector<Retired> retired;
+};
+thread_local ThreadState tl_epoch;
+
+void reclaim(ThreadState& state) noexcept {
+  try_advance();
+  delete_expired(state.retired);
+  if (g_has_orphans.load(std::memory_order_relaxed)) {
+    std::vector<Retired> orphans;
+    {
+      std::lock_guard lock(g_orphans_mutex);
+      orphans.swap(g_orphans);
+      g_has_orphans.store(false, std::memory_order_relaxed);
+    }
+    // Adopted, the kept ones are deleted along with the thread's own.
+    delete_expired(orphans);
+    std::move(orphans.begin(), orphans.end(), std::back_inserter(state.retired));
+  }
+}
+}  // namespace
+
+EpochGuard::EpochGuard() noexcept {
+  auto& state = tl_epoch;
+  if (state.depth++ > 0)
+    return;
+  auto& participant = state.get_participant();
+  participant.state.store((g_epoch.load(std::memory_order_relaxed) << 1) | kPinned,
+                          std::memory_order_relaxed);
+  // Pairs with the fence in `try_advance`: either the pin is seen there, or the reads
+  // below see no object, unlinked before the epoch has advanced.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+EpochGuard::~EpochGuard() noexcept {
+  auto& state = tl_epoch;
+  if (--state.depth > 0)
+    return;
+  state.participant->state.store(0, std::memory_order_release);
+}
+
+void epoch_reclaim() noexcept {
+  auto& state = tl_epoch;
+  if (state.depth > 0)
+    return;
+  if (state.retired.empty() && !g_has_orphans.load(std::memory_order_relaxed))
+    return;
+  reclaim(state);
+}
+
+namespace internal {
+void epoch_retire(void* object, void (*deleter)(void*)) {
+  auto& state = tl_epoch;
+  // The object is unlinked by now: a reader, which still may see it, has pinned no
+  // later than the epoch loaded after the fence.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  state.retired.push_back(
+      Retired{object, deleter, g_epoch.load(std::memory_order_relaxed)});
+  if (state.retired.size() >= kReclaimThreshold && state.depth == 0) {
+    reclaim(state);
+  }
+}
+}  // namespace internal
+
+}  // namespace base
@@ -0,0 +1,55 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/macro.hpp"
+
+#include "base/config.hpp"
+
+namespace base {
+
+namespace internal {
+BASE_PUBLIC void epoch_retire(void* object, void (*deleter)(void*)) /* may throw */;
+}  // namespace internal
+
+// Epoch-based reclamation, for the lock-free structures, which unlink the objects,
+// other threads may still be reading. The readers pin the current epoch with an
+// `EpochGuard` for as long as they use the objects, and the writers retire the
+// unlinked objects with `epoch_retire()`. A retired object is deleted once the global
+// epoch has advanced twice since, which it only does when every pinned thread has
+// seen the current epoch.
+//
+// Pins the current epoch for the thread. Guards nest; the outermost one unpins.
+class BASE_PUBLIC EpochGuard {
+ public:
+  EpochGuard() noexcept;
+  ~EpochGuard() noexcept;
+
+  DISABLE_COPY_MOVE(EpochGuard);
+};
+
+// Deletes the object once no thread can be reading it anymore.
+template <class T>
+void epoch_retire(T* object) /* may throw */ {
+  internal::epoch_retire(object, [](void* retired) { delete static_cast<T*>(retired); });
+}
+
+// A quiescent point: tries to advance the epoch and deletes the objects, which are
+// safe to delete. Retiring does this now and then too, RunLoop does on every iteration.
+// Does nothing while the thread is pinned.
+BASE_PUBLIC void epoch_reclaim() noexcept;
+
+}  // namespace base
@@ -0,0 +1,92 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/epoch.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+class Object {
+ public:
+  explicit Object(std::atomic<int>* deleted) : deleted_(deleted) {}
+  ~Object() { deleted_->fetch_add(1); }
+
+ private:
+  std::atomic<int>* deleted_;
+};
+
+// Enough quiescent points for the epoch to advance twice.
+void reclaim_all() {
+  for (int i = 0; i < 3; ++i) {
+    base::epoch_reclaim();
+  }
+}
+
+}  // namespace
+
+TEST(EpochTest, DeletesRetiredWhenNotPinned) {
+  std::atomic<int> deleted = 0;
+  base::epoch_retire(new Object(&deleted));
+  reclaim_all();
+  EXPECT_EQ(deleted, 1);
+}
+
+TEST(EpochTest, PinnedReaderDelaysDeletion) {
+  std::atomic<int> deleted = 0;
+  std::atomic<bool> pinned = false;
+  std::atomic<bool> unpin = false;
+
+  std::thread reader([&]() {
+    base::EpochGuard guard;
+    pinned = true;
+    pinned.notify_one();
+    unpin.wait(false);
+  });
+  pinned.wait(false);
+
+  base::epoch_retire(new Object(&deleted));
+  reclaim_all();
+  EXPECT_EQ(deleted, 0);
+
+  unpin = true;
+  unpin.notify_one();
+  reader.join();
+  reclaim_all();
+  EXPECT_EQ(deleted, 1);
+}
+
+TEST(EpochTest, NoReclaimWhilePinned) {
+  std::atomic<int> deleted = 0;
+  {
+    base::EpochGuard guard;
+    base::EpochGuard nested;
+    base::epoch_retire(new Object(&deleted));
+    reclaim_all();
+    EXPECT_EQ(deleted, 0);
+  }
+  reclaim_all();
+  EXPECT_EQ(deleted, 1);
+}
+
+TEST(EpochTest, AdoptsRetiredOfExitedThreads) {
+  std::atomic<int> deleted = 0;
+  std::thread([&]() { base::epoch_retire(new Object(&deleted)); }).join();
+  reclaim_all();
+  EXPECT_EQ(deleted, 1);
+}
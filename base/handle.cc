@@ -0,0 +1,36 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/handle.hpp"
+
+namespace base {
+
+namespace internal {
+HandleRegistry& handle_registry() noexcept {
+  thread_local HandleRegistry registry;
+  return registry;
+}
+}  // namespace internal
+
+Handled::Handled()
+    : registry_(&internal::handle_registry()), key_(registry_->insert(this)) {}
+
+Handled::~Handled() noexcept {
+  ASSERT(registry_ == &internal::handle_registry())
+      << "Handled is destroyed on a foreign thread";
+  registry_->erase(key_);
+}
+
+}  // namespace base
@@ -0,0 +1,110 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/debug/debug.hpp"
+#include "base/macro.hpp"
+#include "base/slot_map.hpp"
+
+#include "base/config.hpp"
+
+#include <cstddef>
+#include <concepts>
+#include <type_traits>
+
+namespace base {
+
+class Handled;
+
+namespace internal {
+using HandleKey = SlotMap<Handled*>::Key;
+
+using HandleRegistry = SlotMap<Handled*>;
+
+// The live `Handled` objects, created by the calling thread.
+BASE_PUBLIC HandleRegistry& handle_registry() noexcept;
+}  // namespace internal
+
+// Base for the objects, referred to by `Handle`s. Registers the object in its thread's
+// slot map for its lifetime, so it costs no allocation of its own. Must be destroyed
+// on the thread, which has created it.
+class BASE_PUBLIC Handled {
+ public:
+  DISABLE_COPY_MOVE(Handled);
+
+ protected:
+  Handled() /* may throw */;
+  ~Handled() noexcept;
+
+ private:
+  template <class T>
+  requires std::is_base_of_v<Handled, T>
+  friend class Handle;
+
+  internal::HandleRegistry* const registry_;
+  const internal::HandleKey key_;
+};
+
+// Lightweight alternative to `weak_ref` for the objects used by one thread: a slot
+// index and a generation in the registry of the thread, which has created the object,
+// so it may only be used there. Checking it is a lookup in a vector, with no
+// ref-counting.
+// Doesn't keep the object alive, so `get()` must not be held over anything which can
+// destroy it.
+template <class T>
+requires std::is_base_of_v<Handled, T>
+class Handle {
+ public:
+  Handle() = default;
+  /* implicit */ Handle(std::nullptr_t) {}
+  explicit Handle(T* object) noexcept
+      : registry_(object ? object->registry_ : nullptr)
+      , key_(object ? object->key_ : internal::HandleKey{}) {}
+
+  template <class D> requires std::convertible_to<D*, T*>
+  Handle(const Handle<D>& rhs) noexcept : registry_(rhs.registry_), key_(rhs.key_) {}
+
+  // Returns `nullptr` if the object is destroyed.
+  GETTER T* get() const noexcept {
+    if (!registry_)
+      return nullptr;
+    ASSERT(registry_ == &internal::handle_registry())
+        << "Handle is used on a foreign thread";
+    auto* const* object = registry_->get(key_);
+    return object ? static_cast<T*>(*object) : nullptr;
+  }
+
+  explicit operator bool() const noexcept { return get() != nullptr; }
+
+  bool operator==(const Handle& rhs) const noexcept {
+    return registry_ == rhs.registry_ && key_ == rhs.key_;
+  }
+
+  template <class D> requires std::convertible_to<const D*, const T*>
+  bool operator==(D* rhs) const noexcept {
+    return get() == rhs;
+  }
+
+ private:
+  template <class D>
+  requires std::is_base_of_v<Handled, D>
+  friend class Handle;
+
+  internal::HandleRegistry* registry_ = nullptr;
+  internal::HandleKey key_;
+};
+
+}  // namespace base
@@ -0,0 +1,89 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/handle.hpp"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class Object : public base::Handled {
+ public:
+  virtual ~Object() = default;
+  int data = 0;
+};
+
+class DerivedObject : public Object {};
+
+}  // namespace
+
+TEST(HandleTest, NullByDefault) {
+  base::Handle<Object> handle;
+
+  EXPECT_FALSE(handle);
+  EXPECT_EQ(handle.get(), nullptr);
+}
+
+TEST(HandleTest, ResolvesWhileAlive) {
+  auto object = std::make_unique<Object>();
+  base::Handle handle(object.get());
+
+  EXPECT_TRUE(handle);
+  EXPECT_EQ(handle.get(), object.get());
+  EXPECT_EQ(handle, object.get());
+
+  object.reset();
+  EXPECT_FALSE(handle);
+  EXPECT_EQ(handle.get(), nullptr);
+}
+
+TEST(HandleTest, NotConfusedByReusedSlot) {
+  auto object = std::make_unique<Object>();
+  base::Handle handle(object.get());
+  object.reset();
+
+  auto other = std::make_unique<Object>();
+  EXPECT_EQ(handle.get(), nullptr);
+  EXPECT_EQ(base::Handle(other.get()).get(), other.get());
+}
+
+TEST(HandleTest, ConvertsToBase) {
+  DerivedObject object;
+  base::Handle<Object> handle = base::Handle(&object);
+
+  EXPECT_EQ(handle.get(), &object);
+  EXPECT_EQ(handle, base::Handle<Object>(&object));
+}
+
+TEST(HandleTest, ThreadsHaveTheirOwnRegistries) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 1000; ++i) {
+        auto object = std::make_unique<Object>();
+        base::Handle handle(object.get());
+        EXPECT_EQ(handle.get(), object.get());
+        object.reset();
+        EXPECT_EQ(handle.get(), nullptr);
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+}
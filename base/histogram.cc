@@ -0,0 +1,54 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace base {
+
+std::uint64_t Histogram::value_at_percentile(double percentile) const noexcept {
+  if (count_ == 0)
+    return 0;
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * count_)));
+  std::uint64_t seen = 0;
+  for (auto index = 0u; index < kBucketsCount; ++index) {
+    seen += counts_[index];
+    if (seen >= rank)
+      return std::min(highest_value_of(index), max_);
+  }
+  return max_;
+}
+
+void Histogram::reset() noexcept {
+  counts_.fill(0);
+  count_ = 0;
+  sum_ = 0;
+  min_ = std::numeric_limits<std::uint64_t>::max();
+  max_ = 0;
+}
+
+void Histogram::print(std::ostream& out, double divisor) const {
+  const auto scaled = [divisor](std::uint64_t value) { return value / divisor; };
+  out << "count=" << count_ << " mean=" << scaled(mean())
+      << " p50=" << scaled(value_at_percentile(50))
+      << " p90=" << scaled(value_at_percentile(90))
+      << " p99=" << scaled(value_at_percentile(99)) << " max=" << scaled(max_);
+}
+
+}  // namespace base
@@ -0,0 +1,93 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/macro.hpp"
+
+#include "base/config.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+
+namespace base {
+
+// Log-linear histogram of unsigned values in the HdrHistogram fashion: each power of two
+// range is split into `kSubBuckets` linear buckets, so any recorded value is known
+// within ~3% and recording is a couple of bit operations and an increment, with no
+// allocations. Not thread-safe.
+class BASE_PUBLIC Histogram {
+ public:
+  static constexpr int kSubBucketBits = 6;
+
+  void record(std::uint64_t value) noexcept {
+    ++counts_[index_of(value)];
+    ++count_;
+    sum_ += value;
+    min_ = value < min_ ? value : min_;
+    max_ = value > max_ ? value : max_;
+  }
+
+  GETTER std::uint64_t count() const noexcept { return count_; }
+  GETTER std::uint64_t min() const noexcept { return count_ ? min_ : 0; }
+  GETTER std::uint64_t max() const noexcept { return max_; }
+  GETTER std::uint64_t mean() const noexcept { return count_ ? sum_ / count_ : 0; }
+
+  // The value, which `percentile`% of the recorded values don't exceed (within the
+  // precision). `percentile` is in [0, 100].
+  std::uint64_t value_at_percentile(double percentile) const noexcept;
+
+  void reset() noexcept;
+
+  // Prints count, mean, percentiles and max, scaling the values by `1 / divisor`.
+  void print(std::ostream& out, double divisor = 1.0) const;
+
+ private:
+  static constexpr std::size_t kHalfBucket = std::size_t{1} << (kSubBucketBits - 1);
+  static constexpr std::size_t kBucketsCount =
+      (std::numeric_limits<std::uint64_t>::digits - kSubBucketBits + 2) * kHalfBucket;
+
+  // The values below `2 * kHalfBucket` get a bucket each, the greater ones - the bucket
+  // of their top `kSubBucketBits` bits.
+  static constexpr std::size_t index_of(std::uint64_t value) noexcept {
+    const int width = std::bit_width(value);
+    if (width <= kSubBucketBits)
+      return static_cast<std::size_t>(value);
+    const int shift = width - kSubBucketBits;
+    return static_cast<std::size_t>(shift) * kHalfBucket +
+           static_cast<std::size_t>(value >> shift);
+  }
+
+  // The greatest value, falling into the bucket.
+  static constexpr std::uint64_t highest_value_of(std::size_t index) noexcept {
+    if (index < 2 * kHalfBucket)
+      return index;
+    const auto shift = index / kHalfBucket - 1;
+    const auto mantissa = index - shift * kHalfBucket;
+    return (std::uint64_t{mantissa} << shift) + ((std::uint64_t{1} << shift) - 1);
+  }
+
+  std::array<std::uint64_t, kBucketsCount> counts_{};
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_ = 0;
+  std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+  std::uint64_t max_ = 0;
+};
+
+}  // namespace base
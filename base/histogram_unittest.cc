@@ -0,0 +1,60 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/histogram.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <sstream>
+
+TEST(HistogramTest, SmallValuesAreExact) {
+  base::Histogram histogram;
+  EXPECT_EQ(histogram.value_at_percentile(50), 0u);
+
+  for (std::uint64_t value = 1; value <= 10; ++value) {
+    histogram.record(value);
+  }
+  EXPECT_EQ(histogram.count(), 10u);
+  EXPECT_EQ(histogram.min(), 1u);
+  EXPECT_EQ(histogram.max(), 10u);
+  EXPECT_EQ(histogram.mean(), 5u);
+  EXPECT_EQ(histogram.value_at_percentile(50), 5u);
+  EXPECT_EQ(histogram.value_at_percentile(100), 10u);
+}
+
+TEST(HistogramTest, LargeValuesAreWithinPrecision) {
+  base::Histogram histogram;
+  // 1us .. 1s in nanoseconds.
+  for (std::uint64_t value = 1000; value <= 1'000'000'000; value *= 10) {
+    for (int i = 0; i < 10; ++i) {
+      histogram.record(value + i);
+    }
+  }
+  EXPECT_EQ(histogram.count(), 70u);
+
+  const auto p50 = histogram.value_at_percentile(50);
+  EXPECT_GE(p50, 1'000'000u);
+  EXPECT_LE(p50, 1'000'000u * 103 / 100);
+  EXPECT_EQ(histogram.value_at_percentile(100), 1'000'000'009u);
+
+  std::ostringstream out;
+  histogram.print(out, 1000.0);
+  EXPECT_NE(out.str().find("count=70"), std::string::npos);
+
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.max(), 0u);
+}
@@ -0,0 +1,67 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/monotonic_arena.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+namespace base {
+
+namespace {
+constexpr auto kNoBlock = std::numeric_limits<std::size_t>::max();
+}
+
+MonotonicArena::MonotonicArena(std::size_t initial_block_size) noexcept
+    : initial_block_size_(initial_block_size)
+    , current_(kNoBlock)
+    , cursor_(nullptr)
+    , end_(nullptr)
+    , reserved_bytes_(0) {}
+
+MonotonicArena::~MonotonicArena() noexcept = default;
+
+void MonotonicArena::reset() noexcept {
+  current_ = kNoBlock;
+  cursor_ = end_ = nullptr;
+}
+
+void* MonotonicArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  while (true) {
+    void* memory = cursor_;
+    auto space = static_cast<std::size_t>(end_ - cursor_);
+    if (memory && std::align(alignment, bytes, memory, space)) {
+      cursor_ = static_cast<std::byte*>(memory) + bytes;
+      return memory;
+    }
+    // The rest of the block is wasted till the reset. Skips the free blocks, which
+    // are too small for this allocation.
+    const auto needed = bytes + alignment;
+    do {
+      ++current_;
+    } while (current_ < blocks_.size() && blocks_[current_].size < needed);
+    if (current_ == blocks_.size()) {
+      const auto size = std::max(
+          needed, blocks_.empty() ? initial_block_size_ : blocks_.back().size * 2);
+      blocks_.push_back(Block{std::make_unique<std::byte[]>(size), size});
+      reserved_bytes_ += size;
+    }
+    cursor_ = blocks_[current_].memory.get();
+    end_ = cursor_ + blocks_[current_].size;
+  }
+}
+
+}  // namespace base
@@ -0,0 +1,67 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/macro.hpp"
+
+#include "base/config.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace base {
+
+// Monotonic memory resource for the short-lived data, like the structures of one
+// frame: allocating is a pointer bump, deallocating does nothing, and `reset()` frees
+// everything at once. Unlike `std::pmr::monotonic_buffer_resource`, it keeps its
+// blocks over resets, so a steady workload stops touching the heap after the first
+// rounds. Not thread safe.
+class BASE_PUBLIC MonotonicArena final : public std::pmr::memory_resource {
+ public:
+  explicit MonotonicArena(std::size_t initial_block_size = 16 * 1024) noexcept;
+  ~MonotonicArena() noexcept override;
+
+  DISABLE_COPY_MOVE(MonotonicArena);
+
+  // Everything allocated before must be gone by now.
+  void reset() noexcept;
+
+  GETTER std::size_t reserved_bytes() const noexcept { return reserved_bytes_; }
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> memory;
+    std::size_t size;
+  };
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void*, std::size_t, std::size_t) noexcept override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  const std::size_t initial_block_size_;
+  std::vector<Block> blocks_;
+  // Index of the block in use, the blocks after it are free.
+  std::size_t current_;
+  std::byte* cursor_;
+  std::byte* end_;
+  std::size_t reserved_bytes_;
+};
+
+}  // namespace base
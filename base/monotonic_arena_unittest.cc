@@ -0,0 +1,63 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/monotonic_arena.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+TEST(MonotonicArenaTest, AllocatesAligned) {
+  base::MonotonicArena arena{256};
+  for (std::size_t alignment : {1u, 2u, 8u, 16u, 64u}) {
+    auto* memory = arena.allocate(3, alignment);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % alignment, 0u);
+  }
+}
+
+TEST(MonotonicArenaTest, ReusesMemoryAfterReset) {
+  base::MonotonicArena arena{256};
+  std::vector<void*> first;
+  for (int i = 0; i < 100; ++i) {
+    first.push_back(arena.allocate(24, 8));
+  }
+  const auto reserved = arena.reserved_bytes();
+
+  arena.reset();
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(arena.allocate(24, 8), first[i]);
+  }
+  EXPECT_EQ(arena.reserved_bytes(), reserved);
+}
+
+TEST(MonotonicArenaTest, FitsLargeAllocations) {
+  base::MonotonicArena arena{256};
+  EXPECT_NE(arena.allocate(16, 8), nullptr);
+  auto* large = static_cast<char*>(arena.allocate(4096, 16));
+  large[4095] = 1;
+  EXPECT_GE(arena.reserved_bytes(), 4096u);
+}
+
+TEST(MonotonicArenaTest, BacksPmrContainers) {
+  base::MonotonicArena arena;
+  std::pmr::vector<int> values(&arena);
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(i);
+  }
+  EXPECT_EQ(values.back(), 999);
+  EXPECT_EQ(values.get_allocator().resource(), &arena);
+}
@@ -0,0 +1,87 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/object_pool.hpp"
+
+#include "base/debug/debug.hpp"
+
+#include <new>
+
+namespace base {
+
+struct alignas(ObjectPool::kAlignment) ObjectPool::Header {
+  ref_ptr<ObjectPool> pool;
+  std::uint32_t size_class;
+};
+
+ObjectPool::ObjectPool() noexcept
+    : slab_cursor_(nullptr)
+    , slab_end_(nullptr)
+    , free_lists_(kMaxPooledSize / kGranularity + 1, nullptr)
+    , live_objects_(0)
+    , reserved_bytes_(0) {}
+
+ObjectPool::~ObjectPool() noexcept {
+  ASSERT(live_objects_ == 0);
+}
+
+void* ObjectPool::allocate(std::size_t size) {
+  const auto block_size = (size + sizeof(Header) + kGranularity - 1) / kGranularity *
+                          kGranularity;
+  std::byte* memory;
+  std::uint32_t size_class;
+  if (block_size > kMaxPooledSize) {
+    memory = static_cast<std::byte*>(
+        ::operator new(block_size));
+    size_class = kLargeClass;
+  } else {
+    size_class = static_cast<std::uint32_t>(block_size / kGranularity);
+    if (auto* free = free_lists_[size_class]) {
+      free_lists_[size_class] = free->next;
+      memory = reinterpret_cast<std::byte*>(free);
+    } else {
+      if (static_cast<std::size_t>(slab_end_ - slab_cursor_) < block_size) {
+        // The rest of the current slab is abandoned.
+        slabs_.emplace_back(new std::byte[kSlabSize]);
+        slab_cursor_ = slabs_.back().get();
+        slab_end_ = slab_cursor_ + kSlabSize;
+        reserved_bytes_ += kSlabSize;
+      }
+      memory = slab_cursor_;
+      slab_cursor_ += block_size;
+    }
+  }
+  new (memory) Header{ref_ptr<ObjectPool>(this), size_class};
+  ++live_objects_;
+  return memory + sizeof(Header);
+}
+
+void ObjectPool::deallocate(void* block) noexcept {
+  auto* memory = static_cast<std::byte*>(block) - sizeof(Header);
+  auto* header = std::launder(reinterpret_cast<Header*>(memory));
+  // Released last, it may be the last reference to the pool.
+  auto pool = std::move(header->pool);
+  const auto size_class = header->size_class;
+  header->~Header();
+  --pool->live_objects_;
+  if (size_class == kLargeClass) {
+    ::operator delete(memory);
+  } else {
+    auto* free = new (memory) FreeBlock{pool->free_lists_[size_class]};
+    pool->free_lists_[size_class] = free;
+  }
+}
+
+}  // namespace base
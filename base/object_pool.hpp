@@ -0,0 +1,102 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/macro.hpp"
+#include "base/ref_ptr.hpp"
+
+#include "base/config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+// Size-class pool for the `RefCounted` objects, which are used together, like the
+// views of one tree. The objects are carved one after another from large slabs, so
+// the objects, allocated together, stay adjacent in memory. Each object keeps the
+// pool alive, the slabs are freed once the pool and all of its objects are gone.
+// Not thread safe.
+class BASE_PUBLIC ObjectPool : public RefCounted {
+ public:
+  // What `new` provides anyway.
+  static constexpr std::size_t kAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+  ObjectPool() noexcept;
+  ~ObjectPool() noexcept override;
+
+  // The memory for an object of `size` bytes, aligned to `kAlignment`.
+  void* allocate(std::size_t size) /* may throw */;
+  // Returns the memory to the pool, which has allocated it.
+  static void deallocate(void* block) noexcept;
+
+  GETTER std::size_t live_objects() const noexcept { return live_objects_; }
+  GETTER std::size_t reserved_bytes() const noexcept { return reserved_bytes_; }
+
+ private:
+  template <class T, class... Args>
+  friend ref_ptr<T> make_ref_ptr_in(ObjectPool* pool, Args&&... args);
+
+  static constexpr std::size_t kGranularity = 16;
+  static constexpr std::size_t kMaxPooledSize = 2048;
+  static constexpr std::size_t kSlabSize = 64 * 1024;
+  // The objects, larger than `kMaxPooledSize`, are allocated one by one.
+  static constexpr std::uint32_t kLargeClass = 0;
+
+  // Precedes each block.
+  struct Header;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static void mark_pooled(RefCounted* object) noexcept { object->pooled_ = true; }
+
+  std::vector<std::unique_ptr<std::byte[]>> slabs_;
+  std::byte* slab_cursor_;
+  std::byte* slab_end_;
+  // By size class.
+  std::vector<FreeBlock*> free_lists_;
+  std::size_t live_objects_;
+  std::size_t reserved_bytes_;
+};
+
+// Like `make_ref_ptr`, but allocates the object from `pool`, or the heap if it is null.
+// The object goes back to the pool once its last `ref_ptr` is released.
+template <class T, class... Args>
+ref_ptr<T> make_ref_ptr_in(ObjectPool* pool, Args&&... args) {
+  static_assert(internal::supports_ref_counted<T>, "Only RefCounted objects are pooled");
+  static_assert(alignof(T) <= ObjectPool::kAlignment, "Over-aligned type");
+  if (!pool)
+    return make_ref_ptr<T>(std::forward<Args>(args)...);
+
+  void* block = pool->allocate(sizeof(T));
+  T* object;
+  try {
+    object = new (block) T(std::forward<Args>(args)...);
+  } catch (...) {
+    ObjectPool::deallocate(block);
+    throw;
+  }
+  ObjectPool::mark_pooled(object);
+  return ref_ptr<T>(object);
+}
+
+}  // namespace base
@@ -0,0 +1,101 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/object_pool.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+class Object : public base::RefCounted {
+ public:
+  explicit Object(int* destroyed) : destroyed_(destroyed) {}
+  ~Object() noexcept override { ++*destroyed_; }
+
+  std::uint64_t payload[4] = {};
+
+ private:
+  int* destroyed_;
+};
+
+class LargeObject : public Object {
+ public:
+  using Object::Object;
+
+  char large[4096] = {};
+};
+
+class ThrowingObject : public base::RefCounted {
+ public:
+  ThrowingObject() { throw std::runtime_error("ctor"); }
+};
+
+}  // namespace
+
+TEST(ObjectPoolTest, AllocatesAdjacentObjects) {
+  auto pool = base::make_ref_ptr<base::ObjectPool>();
+  int destroyed = 0;
+  auto a = base::make_ref_ptr_in<Object>(pool.get(), &destroyed);
+  auto b = base::make_ref_ptr_in<Object>(pool.get(), &destroyed);
+
+  const auto distance = reinterpret_cast<std::uintptr_t>(b.get()) -
+                        reinterpret_cast<std::uintptr_t>(a.get());
+  EXPECT_LT(distance, 2 * sizeof(Object));
+  EXPECT_EQ(pool->live_objects(), 2u);
+}
+
+TEST(ObjectPoolTest, ReusesReleasedBlocks) {
+  auto pool = base::make_ref_ptr<base::ObjectPool>();
+  int destroyed = 0;
+  auto a = base::make_ref_ptr_in<Object>(pool.get(), &destroyed);
+  auto* address = a.get();
+  a = nullptr;
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(pool->live_objects(), 0u);
+
+  auto b = base::make_ref_ptr_in<Object>(pool.get(), &destroyed);
+  EXPECT_EQ(b.get(), address);
+}
+
+TEST(ObjectPoolTest, ObjectsOutliveThePoolReference) {
+  int destroyed = 0;
+  std::vector<base::ref_ptr<Object>> objects;
+  {
+    auto pool = base::make_ref_ptr<base::ObjectPool>();
+    for (int i = 0; i < 1000; ++i) {
+      objects.push_back(base::make_ref_ptr_in<Object>(pool.get(), &destroyed));
+    }
+    objects.push_back(base::make_ref_ptr_in<LargeObject>(pool.get(), &destroyed));
+  }
+  objects.clear();
+  EXPECT_EQ(destroyed, 1001);
+}
+
+TEST(ObjectPoolTest, NullPoolAllocatesOnHeap) {
+  int destroyed = 0;
+  auto object = base::make_ref_ptr_in<Object>(nullptr, &destroyed);
+  object = nullptr;
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(ObjectPoolTest, ReturnsBlockIfConstructorThrows) {
+  auto pool = base::make_ref_ptr<base::ObjectPool>();
+  EXPECT_THROW(base::make_ref_ptr_in<ThrowingObject>(pool.get()), std::runtime_error);
+  EXPECT_EQ(pool->live_objects(), 0u);
+}
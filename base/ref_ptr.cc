@@ -16,21 +16,107 @@
 #include "base/ref_ptr.hpp"
 
 #include "base/debug/debug.hpp"
+#include "base/object_pool.hpp"
 
 #include <cassert>
 #include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace base::internal {
 
 namespace {
 constexpr auto UNDEFINED_REFS_TS = std::numeric_limits<int>::min();
+
+constexpr std::int64_t kBiasedMerged = 1;
+constexpr std::int64_t kBiasedQueued = 2;
+constexpr std::int64_t kBiasedOne = 4;
+
+constexpr std::int64_t shared_count(std::int64_t shared) noexcept {
+  return shared >> 2;
+}
+}  // namespace
+
+// Per-thread record, referenced by the objects created on the thread.
+struct BiasedOwner {
+  using object_t = RefCountedImpl<ThreadSafe::BIASED>;
+
+  // The thread, and the objects alive.
+  std::atomic<int> refs{1};
+  std::atomic<bool> has_queued{false};
+  std::mutex mutex;
+  std::vector<const object_t*> queued;
+  bool exited = false;
+
+  void unref() noexcept {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+
+  // Returns `false` if the owner has exited and the object is to be merged right away.
+  bool enqueue(const object_t* object) {
+    std::lock_guard lock(mutex);
+    if (exited)
+      return false;
+    queued.push_back(object);
+    has_queued.store(true, std::memory_order_release);
+    return true;
+  }
+
+  void merge_queued() {
+    std::vector<const object_t*> objects;
+    {
+      std::lock_guard lock(mutex);
+      has_queued.store(false, std::memory_order_relaxed);
+      objects.swap(queued);
+    }
+    for (const auto* object : objects) {
+      object->merge();
+    }
+  }
+};
+
+namespace {
+// Compared with the objects' owners on every reference, so it is kept trivial. The
+// library is linked, not loaded at runtime, so the static TLS model is safe, and it
+// spares a `__tls_get_addr()` call per reference.
+__attribute__((tls_model("initial-exec"))) thread_local BiasedOwner* tl_biased_owner =
+    nullptr;
+
+struct BiasedOwnerHolder {
+  ~BiasedOwnerHolder() {
+    if (!owner)
+      return;
+    // The references, taken on this thread from now on, are shared.
+    tl_biased_owner = nullptr;
+    {
+      std::lock_guard lock(owner->mutex);
+      owner->exited = true;
+    }
+    owner->merge_queued();
+    owner->unref();
+  }
+
+  BiasedOwner* owner = nullptr;
+};
+thread_local BiasedOwnerHolder tl_biased_owner_holder;
+
+BiasedOwner* current_biased_owner() {
+  if (!tl_biased_owner_holder.owner) {
+    tl_biased_owner_holder.owner = new BiasedOwner;
+    tl_biased_owner = tl_biased_owner_holder.owner;
+  }
+  return tl_biased_owner_holder.owner;
 }
+}  // namespace
 
 template <>
-RefCountedImpl<ThreadSafe::SAFE>::RefCountedImpl() noexcept : refs_(UNDEFINED_REFS_TS) {}
+RefCountedImpl<ThreadSafe::SAFE>::RefCountedImpl() noexcept
+    : refs_(UNDEFINED_REFS_TS), pooled_(false) {}
 
 template <>
-RefCountedImpl<ThreadSafe::NOT>::RefCountedImpl() noexcept : refs_(0) {}
+RefCountedImpl<ThreadSafe::NOT>::RefCountedImpl() noexcept : refs_(0), pooled_(false) {}
 
 template <ThreadSafe safe>
 RefCountedImpl<safe>::~RefCountedImpl() noexcept {
@@ -41,6 +127,105 @@ RefCountedImpl<safe>::~RefCountedImpl() noexcept {
   }
 }
 
+RefCountedImpl<ThreadSafe::BIASED>::RefCountedImpl() noexcept
+    : owner_record_(current_biased_owner())
+    , owner_(owner_record_)
+    , biased_(0)
+    , shared_(0) {
+  owner_record_->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+RefCountedImpl<ThreadSafe::BIASED>::~RefCountedImpl() noexcept {
+  ASSERT(shared_count(shared_.load(std::memory_order_relaxed)) <= 0);
+  owner_record_->unref();
+}
+
+void RefCountedImpl<ThreadSafe::BIASED>::add_ref() const noexcept {
+  const auto* owner = owner_.load(std::memory_order_relaxed);
+  if (LIKELY(owner && owner == tl_biased_owner)) {
+    ++biased_;
+  } else {
+    shared_.fetch_add(kBiasedOne, std::memory_order_relaxed);
+  }
+}
+
+void RefCountedImpl<ThreadSafe::BIASED>::release() const noexcept {
+  const auto* owner = owner_.load(std::memory_order_relaxed);
+  if (!owner || owner != tl_biased_owner) {
+    release_shared();
+    return;
+  }
+  if (LIKELY(--biased_ > 0))
+    return;
+  // The owner is done with the object, so the shared counter takes over. The biased
+  // one may be negative, if the owner has released the references taken elsewhere.
+  owner_.store(nullptr, std::memory_order_relaxed);
+  const auto merged = biased_ * kBiasedOne + kBiasedMerged;
+  const auto shared = shared_.fetch_add(merged, std::memory_order_acq_rel) + merged;
+  if (shared_count(shared) == 0) {
+    delete this;
+  }
+}
+
+void RefCountedImpl<ThreadSafe::BIASED>::release_shared() const noexcept {
+  auto shared = shared_.load(std::memory_order_relaxed);
+  while (true) {
+    if (shared & kBiasedMerged) {
+      if (shared_count(shared_.fetch_sub(kBiasedOne, std::memory_order_acq_rel)) == 1) {
+        delete this;
+      }
+      return;
+    }
+    if (shared_count(shared) > 1 || (shared & kBiasedQueued)) {
+      // The owner still holds the object, or the queued reference does.
+      if (shared_.compare_exchange_weak(shared, shared - kBiasedOne,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+        return;
+      }
+      continue;
+    }
+    // Only the owner knows whether this is the last reference. It's kept till the
+    // owner merges the counters.
+    if (shared_.compare_exchange_weak(shared, shared | kBiasedQueued,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_relaxed)) {
+      if (!owner_record_->enqueue(this)) {
+        merge();
+      }
+      return;
+    }
+  }
+}
+
+void RefCountedImpl<ThreadSafe::BIASED>::merge() const noexcept {
+  // Doesn't race with the owner: it either runs on the owner thread, or the owner has
+  // exited.
+  auto merged = -kBiasedOne;
+  if (!(shared_.load(std::memory_order_relaxed) & kBiasedMerged)) {
+    owner_.store(nullptr, std::memory_order_relaxed);
+    merged += std::exchange(biased_, 0) * kBiasedOne + kBiasedMerged;
+  }
+  // Drops the queued reference along the way.
+  const auto shared = shared_.fetch_add(merged, std::memory_order_acq_rel) + merged;
+  if (shared_count(shared) == 0) {
+    delete this;
+  }
+}
+
+template <ThreadSafe safe>
+void RefCountedImpl<safe>::destroy() const noexcept {
+  if (LIKELY(!pooled_)) {
+    delete this;
+    return;
+  }
+  auto* self = const_cast<RefCountedImpl*>(this);
+  // The most derived object starts the block.
+  void* block = dynamic_cast<void*>(self);
+  self->~RefCountedImpl();
+  ObjectPool::deallocate(block);
+}
+
 template <bool is_const, ThreadSafe safe>
 ref_ptr_base<is_const, safe>::ref_ptr_base() noexcept : ptr_(nullptr) {}
 
@@ -60,6 +245,10 @@ ref_ptr_base<is_const, safe>::ref_ptr_base(type* ptr) noexcept : ptr_(ptr) {
       // This case is only valid when locking a weak_ref.
       ptr_ = nullptr;
     }
+  } else if constexpr (safe == ThreadSafe::BIASED) {
+    if (ptr_) {
+      ptr_->add_ref();
+    }
   } else {
     if (ptr_) {
       ++ptr_->refs_;
@@ -73,6 +262,8 @@ ref_ptr_base<is_const, safe>::ref_ptr_base(const ref_ptr_base& rhs) noexcept
   if (ptr_) {
     if constexpr (safe == ThreadSafe::SAFE) {
       ptr_->refs_.fetch_add(1, std::memory_order_relaxed);
+    } else if constexpr (safe == ThreadSafe::BIASED) {
+      ptr_->add_ref();
     } else {
       ++ptr_->refs_;
     }
@@ -88,11 +279,15 @@ template <bool is_const, ThreadSafe safe>
 ref_ptr_base<is_const, safe>::~ref_ptr_base() {
   if constexpr (safe == ThreadSafe::SAFE) {
     if (ptr_ && ptr_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-      delete ptr_;
+      ptr_->destroy();
+    }
+  } else if constexpr (safe == ThreadSafe::BIASED) {
+    if (ptr_) {
+      ptr_->release();
     }
   } else {
     if (ptr_ && --ptr_->refs_ == 0) {
-      delete ptr_;
+      ptr_->destroy();
     }
   }
 }
@@ -104,5 +299,18 @@ template class BASE_PUBLIC ref_ptr_base<true, ThreadSafe::NOT>;
 template class BASE_PUBLIC ref_ptr_base<false, ThreadSafe::NOT>;
 template class BASE_PUBLIC ref_ptr_base<true, ThreadSafe::SAFE>;
 template class BASE_PUBLIC ref_ptr_base<false, ThreadSafe::SAFE>;
+template class BASE_PUBLIC ref_ptr_base<true, ThreadSafe::BIASED>;
+template class BASE_PUBLIC ref_ptr_base<false, ThreadSafe::BIASED>;
 
 }  // namespace base::internal
+
+namespace base {
+
+void merge_biased_ref_counts() noexcept {
+  auto* owner = internal::tl_biased_owner;
+  if (owner && owner->has_queued.load(std::memory_order_acquire)) {
+    owner->merge_queued();
+  }
+}
+
+}  // namespace base
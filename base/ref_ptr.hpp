@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <concepts>
 #include <type_traits>
 #include <utility>
@@ -30,10 +31,19 @@ namespace base::internal {
 enum class ThreadSafe {
   NOT = 0,
   SAFE = 1,
+  // Thread safe, but cheap on the thread which has created the object.
+  BIASED = 2,
 };
 
 template <bool is_const, ThreadSafe safe>
 class ref_ptr_base;
+}  // namespace base::internal
+
+namespace base {
+class ObjectPool;
+}  // namespace base
+
+namespace base::internal {
 
 template <ThreadSafe safe>
 class BASE_PUBLIC RefCountedImpl {
@@ -47,8 +57,49 @@ class BASE_PUBLIC RefCountedImpl {
  private:
   friend internal::ref_ptr_base<true, safe>;
   friend internal::ref_ptr_base<false, safe>;
+  friend class base::ObjectPool;
+
+  // Deletes the object, or returns it to the `ObjectPool` it's allocated from.
+  void destroy() const noexcept;
 
   mutable std::conditional_t<safe == ThreadSafe::SAFE, std::atomic<int>, int> refs_;
+  // Fits into the padding after `refs_`.
+  bool pooled_;
+};
+
+struct BiasedOwner;
+
+// Biased reference counting: the references, taken and released on the thread, which
+// has created the object (its owner), are counted by a plain counter; the others are
+// counted by an atomic shared one. The counters are merged once the owner's counter
+// drops to zero, or the shared one would. In the latter case the object is queued to
+// its owner, which merges the counters in `merge_biased_ref_counts()` or on exit.
+template <>
+class BASE_PUBLIC RefCountedImpl<ThreadSafe::BIASED> {
+ public:
+  DISABLE_COPY_AND_ASSIGN(RefCountedImpl);
+
+ protected:
+  RefCountedImpl() noexcept;
+  virtual ~RefCountedImpl() noexcept;
+
+ private:
+  friend internal::ref_ptr_base<true, ThreadSafe::BIASED>;
+  friend internal::ref_ptr_base<false, ThreadSafe::BIASED>;
+  friend struct BiasedOwner;
+
+  void add_ref() const noexcept;
+  void release() const noexcept;
+  void release_shared() const noexcept;
+  // Called on the owner thread (or after it has exited) for the queued object.
+  void merge() const noexcept;
+
+  BiasedOwner* const owner_record_;
+  // Reset once the counters are merged, all the references are shared after that.
+  mutable std::atomic<BiasedOwner*> owner_;
+  mutable std::int64_t biased_;
+  // The shared count, shifted left by two, and the merged and queued flags.
+  mutable std::atomic<std::int64_t> shared_;
 };
 
 template <bool is_const, ThreadSafe safe>
@@ -67,19 +118,27 @@ class ref_ptr_base {
   type* ptr_;
 };
 
+template <class D, ThreadSafe safe>
+static constexpr bool is_ref_counted = std::is_base_of_v<RefCountedImpl<safe>, D>;
+
 template <class D>
 static constexpr bool supports_ref_counted =
-    std::is_base_of_v<RefCountedImpl<ThreadSafe::NOT>, D> &&
-    !std::is_base_of_v<RefCountedImpl<ThreadSafe::SAFE>, D>;
+    is_ref_counted<D, ThreadSafe::NOT> && !is_ref_counted<D, ThreadSafe::SAFE> &&
+    !is_ref_counted<D, ThreadSafe::BIASED>;
 template <class D>
 static constexpr bool supports_thread_safe_ref_counted =
-    std::is_base_of_v<RefCountedImpl<ThreadSafe::SAFE>, D> &&
-    !std::is_base_of_v<RefCountedImpl<ThreadSafe::NOT>, D>;
+    is_ref_counted<D, ThreadSafe::SAFE> && !is_ref_counted<D, ThreadSafe::NOT> &&
+    !is_ref_counted<D, ThreadSafe::BIASED>;
+template <class D>
+static constexpr bool supports_biased_ref_counted =
+    is_ref_counted<D, ThreadSafe::BIASED> && !is_ref_counted<D, ThreadSafe::NOT> &&
+    !is_ref_counted<D, ThreadSafe::SAFE>;
 
 template <class T>
 using ref_ptr_base_for =
     ref_ptr_base<std::is_const_v<T>,
                  supports_thread_safe_ref_counted<T> ? ThreadSafe::SAFE
+                 : supports_biased_ref_counted<T>    ? ThreadSafe::BIASED
                                                      : ThreadSafe::NOT>;
 
 }  // namespace base::internal
@@ -88,10 +147,20 @@ namespace base {
 
 using RefCounted = internal::RefCountedImpl<internal::ThreadSafe::NOT>;
 using RefCountedThreadSafe = internal::RefCountedImpl<internal::ThreadSafe::SAFE>;
+// Opt-in alternative to `RefCountedThreadSafe` for the objects, which are mostly
+// referenced from the thread, which has created them. Doesn't support weak refs.
+using RefCountedBiased = internal::RefCountedImpl<internal::ThreadSafe::BIASED>;
+
+// Merges the counters of the `RefCountedBiased` objects, created on this thread and
+// released on the others. RunLoop does this once per iteration; the other threads,
+// which share such objects, should call it now and then, or they are only freed
+// when the thread exits.
+BASE_PUBLIC void merge_biased_ref_counts() noexcept;
 
 template <class T>
 requires (internal::supports_ref_counted<T> ||
-          internal::supports_thread_safe_ref_counted<T>)
+          internal::supports_thread_safe_ref_counted<T> ||
+          internal::supports_biased_ref_counted<T>)
 class ref_ptr final : public internal::ref_ptr_base_for<T> {
   using base = internal::ref_ptr_base_for<T>;
  public:
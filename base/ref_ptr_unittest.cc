@@ -18,6 +18,10 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 namespace {
 
 class Object : public base::RefCounted {
@@ -41,6 +45,15 @@ class ObjectWithDestroy : public base::RefCounted {
   ~ObjectWithDestroy() noexcept { destroy(); }
 };
 
+class BiasedObject : public base::RefCountedBiased {
+ public:
+  explicit BiasedObject(std::atomic<int>* destroyed) : destroyed_(destroyed) {}
+  ~BiasedObject() noexcept { destroyed_->fetch_add(1); }
+
+ private:
+  std::atomic<int>* destroyed_;
+};
+
 }  // namespace
 
 TEST(RefPtrTest, NullByDefault) {
@@ -164,3 +177,60 @@ TEST(RefPtrTest, DerivedTest) {
   p1 = d1;
   p1 = std::move(d1);
 }
+
+TEST(RefPtrTest, BiasedReleasedOnOwnerThread) {
+  std::atomic<int> destroyed = 0;
+  auto p = base::make_ref_ptr<BiasedObject>(&destroyed);
+  auto p1 = p;
+  p = nullptr;
+  EXPECT_EQ(destroyed, 0);
+  p1 = nullptr;
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(RefPtrTest, BiasedReleasedOnOtherThread) {
+  std::atomic<int> destroyed = 0;
+  auto p = base::make_ref_ptr<BiasedObject>(&destroyed);
+  std::thread([p = std::move(p)]() mutable { p = nullptr; }).join();
+  // Only the owner can tell it was the last reference.
+  EXPECT_EQ(destroyed, 0);
+  base::merge_biased_ref_counts();
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(RefPtrTest, BiasedOwnerThreadExits) {
+  std::atomic<int> destroyed = 0;
+  base::ref_ptr<BiasedObject> p;
+  std::thread([&]() { p = base::make_ref_ptr<BiasedObject>(&destroyed); }).join();
+  auto p1 = p;
+  p = nullptr;
+  EXPECT_EQ(destroyed, 0);
+  p1 = nullptr;
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(RefPtrTest, BiasedSharedBetweenThreads) {
+  constexpr int kThreads = 4;
+  constexpr int kCopies = 10000;
+  std::atomic<int> destroyed = 0;
+  auto p = base::make_ref_ptr<BiasedObject>(&destroyed);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([copy = p]() {
+      for (int j = 0; j < kCopies; ++j) {
+        auto local = copy;
+      }
+    });
+  }
+  for (int j = 0; j < kCopies; ++j) {
+    auto local = p;
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(destroyed, 0);
+  p = nullptr;
+  base::merge_biased_ref_counts();
+  EXPECT_EQ(destroyed, 1);
+}
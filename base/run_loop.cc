@@ -15,50 +15,248 @@
 
 #include "base/run_loop.hpp"
 
+#include "base/dary_heap.hpp"
 #include "base/debug/debug.hpp"
+#include "base/epoch.hpp"
+#include "base/exception.hpp"
 #include "base/ref_ptr.hpp"
+#include "base/spsc_ring.hpp"
 #include "base/weak_ref.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <cstddef>
-#include <list>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
 #include <stack>
 #include <thread>
 #include <utility>
 #include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace base {
 
+namespace internal {
+// Unbounded queue of the tasks, posted by one thread to one loop. It is a chain of
+// fixed rings: the producer starts a new one when its current ring is full, and the
+// consumer frees the rings it has emptied.
+class RunLoopProducer {
+ public:
+  RunLoopProducer() : head_(new Segment), tail_(head_) {}
+  ~RunLoopProducer() noexcept {
+    while (head_) {
+      delete std::exchange(head_, head_->next.load(std::memory_order::relaxed));
+    }
+  }
+
+  DISABLE_COPY_MOVE(RunLoopProducer);
+
+  // Producer side.
+  void push(RunLoop::Task&& task) {
+    if (tail_->ring.try_emplace(std::move(task)))
+      return;
+    auto* segment = new Segment;
+    segment->ring.try_emplace(std::move(task));
+    tail_->next.store(segment, std::memory_order::release);
+    tail_ = segment;
+  }
+
+  // Consumer side.
+  std::optional<RunLoop::Task> pop() noexcept {
+    while (true) {
+      if (auto task = head_->ring.try_pop())
+        return task;
+      auto* next = head_->next.load(std::memory_order::acquire);
+      if (!next)
+        return {};
+      // The producer might have pushed to the ring before moving on.
+      if (auto task = head_->ring.try_pop())
+        return task;
+      delete std::exchange(head_, next);
+    }
+  }
+
+  GETTER bool empty() const noexcept {
+    return head_->ring.empty() && !head_->next.load(std::memory_order::acquire);
+  }
+
+  // Set by the producer thread on exit: the queue is dropped once drained.
+  std::atomic<bool> abandoned{false};
+  // Set by the loop on destruction: the producer thread forgets the queue.
+  std::atomic<bool> loop_gone{false};
+
+ private:
+  struct Segment {
+    SpscRing<RunLoop::Task, 64> ring;
+    std::atomic<Segment*> next{nullptr};
+  };
+
+  Segment* head_;
+  Segment* tail_;
+};
+}  // namespace internal
+
 namespace {
 thread_local std::stack<RunLoop*, std::vector<RunLoop*>> tl_run_loops;
 std::atomic<RunLoop*> g_main_loop;
+std::atomic<std::uint64_t> g_next_loop_id{0};
+
+// The queues of the current thread in the loops it has posted to.
+struct ThreadProducers {
+  struct Entry {
+    std::uint64_t loop_id;
+    std::shared_ptr<internal::RunLoopProducer> producer;
+  };
+
+  ~ThreadProducers() {
+    for (auto& entry : entries) {
+      entry.producer->abandoned.store(true, std::memory_order::release);
+    }
+  }
+
+  std::vector<Entry> entries;
+};
+thread_local ThreadProducers tl_producers;
+
+struct Timer {
+  RunLoop::time_point_t time;
+  // Keeps the tasks with the same deadline in the posting order.
+  std::uint64_t sequence;
+  base::weak_ref<RunLoop::DelayedTask> task;
+
+  bool operator<(const Timer& other) const noexcept {
+    return time < other.time || (time == other.time && sequence < other.sequence);
+  }
+};
+
+// Rounds up to the end of the slack window, so the timers, falling into the same
+// window, fire at one wakeup.
+RunLoop::time_point_t coalesce(RunLoop::time_point_t time) noexcept {
+  const RunLoop::duration_t slack = RunLoop::kTimerSlack;
+  const auto remainder = time.time_since_epoch() % slack;
+  return remainder == slack.zero() ? time : time + (slack - remainder);
+}
+
+std::uint64_t to_nanoseconds(RunLoop::duration_t duration) noexcept {
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+}
 }  // namespace
 
 RunLoop::RunLoop() noexcept : 
-  queues_{}
+  id_(g_next_loop_id.fetch_add(1, std::memory_order::relaxed))
+  , queues_{}
   , queue_ptrs_{}
+  , has_new_producers_(false)
   , exit_when_idle_(false)
   , running_(false)
+  , sleeping_(false)
   , idle_(false)
+  , epoll_fd_(::epoll_create1(EPOLL_CLOEXEC))
+  , wakeup_fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+  , instrumented_(false)
   {
     for (auto i = 0u; i < kQueuesCount; ++i) {
       queue_ptrs_[i] = &queues_[i];
     }
+    ASSERT(epoll_fd_ != -1 && wakeup_fd_ != -1) << "Can't create RunLoop fds";
+    epoll_event event{.events = EPOLLIN, .data = {.fd = wakeup_fd_}};
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event);
   }
 
-RunLoop::~RunLoop() noexcept = default;
+RunLoop::~RunLoop() noexcept {
+  {
+    std::lock_guard lock(new_producers_mutex_);
+    std::move(new_producers_.begin(), new_producers_.end(),
+              std::back_inserter(producers_));
+  }
+  for (auto& producer : producers_) {
+    producer->loop_gone.store(true, std::memory_order::relaxed);
+  }
+  ::close(wakeup_fd_);
+  ::close(epoll_fd_);
+}
 
 auto RunLoop::acquire_queue(std::size_t index) noexcept -> queue_t* {
   queue_t* queue;
-  do {
-    queue = queue_ptrs_[index].exchange(nullptr, std::memory_order::acquire);
-  } while(!queue);
+  while (!(queue = queue_ptrs_[index].exchange(nullptr, std::memory_order::acquire))) {
+    // Blocks (after a short spin) until the queue is stored back.
+    queue_ptrs_[index].wait(nullptr, std::memory_order::relaxed);
+  }
   return queue;
 }
 
 void RunLoop::store_queue(queue_t* queue, std::size_t index) noexcept {
   queue_ptrs_[index].store(queue, std::memory_order::release);
+  queue_ptrs_[index].notify_one();
+}
+
+bool RunLoop::has_tasks() noexcept {
+  if (has_new_producers_.load(std::memory_order::acquire))
+    return true;
+  for (const auto& producer : producers_) {
+    if (!producer->empty())
+      return true;
+  }
+  for (auto index = 0u; index < kQueuesCount; ++index) {
+    auto* queue = acquire_queue(index);
+    const bool empty = queue->delayed_tasks.empty();
+    store_queue(queue, index);
+    if (!empty)
+      return true;
+  }
+  return false;
+}
+
+auto RunLoop::producer() noexcept -> internal::RunLoopProducer& {
+  auto& entries = tl_producers.entries;
+  for (const auto& entry : entries) {
+    if (entry.loop_id == id_)
+      return *entry.producer;
+  }
+  // Forget the destroyed loops before growing the list.
+  std::erase_if(entries, [](const auto& entry) {
+    return entry.producer->loop_gone.load(std::memory_order::relaxed);
+  });
+  auto producer = std::make_shared<internal::RunLoopProducer>();
+  {
+    std::lock_guard lock(new_producers_mutex_);
+    new_producers_.push_back(producer);
+  }
+  has_new_producers_.store(true, std::memory_order::release);
+  return *entries.emplace_back(ThreadProducers::Entry{id_, std::move(producer)}).producer;
+}
+
+void RunLoop::take_posted_tasks(
+    std::array<std::vector<Task>, kPrioritiesCount>& tasks) noexcept {
+  if (has_new_producers_.exchange(false, std::memory_order::acquire)) {
+    std::lock_guard lock(new_producers_mutex_);
+    std::move(new_producers_.begin(), new_producers_.end(),
+              std::back_inserter(producers_));
+    new_producers_.clear();
+  }
+  std::erase_if(producers_, [&tasks](const auto& producer) {
+    // Checked before draining, so the tasks, pushed before the thread exited,
+    // are all taken.
+    const bool abandoned = producer->abandoned.load(std::memory_order::acquire);
+    for (auto count = 0u; count < kMaxTasksPerProducer; ++count) {
+      auto task = producer->pop();
+      if (!task)
+        break;
+      tasks[static_cast<std::size_t>(task->priority)].push_back(std::move(*task));
+    }
+    return abandoned && producer->empty();
+  });
 }
 
 auto RunLoop::queue_index() noexcept -> std::size_t {
@@ -66,55 +264,134 @@ auto RunLoop::queue_index() noexcept -> std::size_t {
   return std::hash<std::thread::id>{}(ti) % RunLoop::kQueuesCount;
 }
 
-void RunLoop::run(task_t on_idle) {
+void RunLoop::run(callback_t on_idle) {
   ASSERT(!running_) << "Can't restart already running RunLoop";
   tl_run_loops.push(this);
   running_ = true;
 
-  std::list<base::weak_ref<DelayedTask>> delayed_tasks;
+  // Cancelled timers are not removed from the heap right away, they are just dropped
+  // once they reach the top.
+  base::DaryHeap<Timer> timers;
+  std::uint64_t timer_sequence = 0;
+  // The vectors here and in the queues keep their capacity, so posting doesn't
+  // allocate in the steady state.
+  std::array<std::vector<Task>, kPrioritiesCount> tasks;
+  std::vector<base::weak_ref<DelayedTask>> new_delayed_tasks;
+  // Carried over between the iterations, till there is time to run them.
+  std::deque<Task> idle_tasks;
+  // While the idle tasks are queued, `before_sleep_` runs once per idle time slice.
+  time_point_t next_before_sleep{};
 
   while (!exit_when_idle_ || !idle_) {
-    if (idle_) {
+    if (idle_ && on_idle) {
       on_idle();
     }
 
+    const bool instrumented = instrumented_.load(std::memory_order::relaxed);
+    const auto iteration_start = instrumented ? clock_t::now() : time_point_t{};
+    const auto idle_time_before = instrumented ? stats_->idle_time : duration_t{};
+
     bool did_work = false;
+    base::merge_biased_ref_counts();
+    base::epoch_reclaim();
+    take_posted_tasks(tasks);
     for (auto index = 0u; index < kQueuesCount; ++index) {
       auto* queue = acquire_queue(index);
-      // Extract the queued tasks
-      auto tasks = std::move(queue->tasks);
-      auto new_delayed_tasks = std::move(queue->delayed_tasks);
-
-      queue->tasks.clear();
-      queue->delayed_tasks.clear();
+      new_delayed_tasks.swap(queue->delayed_tasks);
       // Unlock the queue as fast as possible
       store_queue(queue, index);
 
-      for (auto& task : tasks) {
-        task.runnable();
-      }
-
       for (auto&& delayed_task : new_delayed_tasks) {
-        delayed_tasks.emplace_front(std::move(delayed_task));
+        if (auto task = delayed_task.lock()) {
+          timers.push(Timer{task->time, timer_sequence++, std::move(delayed_task)});
+        }
       }
+      new_delayed_tasks.clear();
+    }
 
-      did_work = did_work || !tasks.empty();
+    if (!timers.empty()) {
+      const auto now = clock_t::now();
+      while (!timers.empty() && timers.top().time <= now) {
+        auto timer = timers.take();
+        if (auto task = timer.task.lock()) {
+          // Still may be cancelled by the tasks, running before it.
+          tasks[static_cast<std::size_t>(task->priority)].push_back(Task{
+              [task = std::move(timer.task)]() {
+                if (auto alive = task.lock())
+                  alive->runnable();
+              },
+              task->priority, task->from, instrumented ? task->time : time_point_t{}});
+        }
+      }
     }
 
-    if (!delayed_tasks.empty()) {
-      delayed_tasks.remove_if([&did_work](const base::weak_ref<DelayedTask>& task_ref) {
-        if (auto task = task_ref.lock()) {
-          if (task->time <= clock_t::now()) {
-            task->runnable();
-            did_work = true;
-            return true;
-          }
+    if (instrumented) {
+      std::size_t ready = idle_tasks.size();
+      for (const auto& prioritized : tasks) {
+        ready += prioritized.size();
+      }
+      stats_->ready_tasks.record(ready);
+    }
 
-          return false;
+    for (auto priority = 0u; priority < kPrioritiesCount; ++priority) {
+      if (priority == static_cast<std::size_t>(Priority::IDLE)) {
+        std::move(tasks[priority].begin(), tasks[priority].end(),
+                  std::back_inserter(idle_tasks));
+      } else {
+        for (auto& task : tasks[priority]) {
+          run_task(task, instrumented);
         }
+        did_work = did_work || !tasks[priority].empty();
+      }
+      tasks[priority].clear();
+    }
+    while (!timers.empty() && timers.top().task.expired()) {
+      // Don't wake up for the cancelled ones.
+      timers.pop();
+    }
+    std::optional<time_point_t> next_deadline;
+    if (!timers.empty()) {
+      next_deadline = coalesce(timers.top().time);
+    }
 
-        return true;
-      });
+    if (!did_work && !on_idle && before_sleep_ &&
+        (idle_tasks.empty() || clock_t::now() >= next_before_sleep)) {
+      // Whatever it posts wakes the loop up right away.
+      before_sleep_();
+      next_before_sleep = clock_t::now() + kIdleTimeSlice;
+    }
+
+    if (!idle_tasks.empty()) {
+      auto until = clock_t::now() + kIdleTimeSlice;
+      if (frame_deadline_)
+        until = std::min(until, *frame_deadline_);
+      // Past the deadline one task still runs, if there is nothing else to do.
+      bool run_one = !did_work;
+      while (!idle_tasks.empty() && (run_one || clock_t::now() < until)) {
+        run_one = false;
+        auto task = std::move(idle_tasks.front());
+        idle_tasks.pop_front();
+        run_task(task, instrumented);
+        did_work = true;
+      }
+    }
+
+    // Only sleep if there is nothing to do, otherwise just check the fds.
+    bool sleep = !did_work && !on_idle && !exit_when_idle_;
+    if (sleep) {
+      sleeping_.store(true, std::memory_order::relaxed);
+      // Pairs with the fence in `notify()`: either the poster sees `sleeping_` and
+      // wakes the loop up, or the loop sees the posted task here.
+      std::atomic_thread_fence(std::memory_order::seq_cst);
+      sleep = !has_tasks() && !exit_when_idle_;
+    }
+    did_work = wait_fds(sleep ? next_deadline : clock_t::now(), instrumented) || did_work;
+    sleeping_.store(false, std::memory_order::relaxed);
+
+    if (instrumented) {
+      const auto slept = stats_->idle_time - idle_time_before;
+      stats_->busy_time += clock_t::now() - iteration_start - slept;
+      ++stats_->iterations;
     }
 
     idle_ = !did_work;
@@ -124,27 +401,186 @@ void RunLoop::run(task_t on_idle) {
   running_ = false;
 }
 
+void RunLoop::run_task(Task& task, bool instrumented) {
+  if (!instrumented) {
+    task.runnable();
+    return;
+  }
+
+  const auto start = clock_t::now();
+  if (task.posted != time_point_t{})
+    stats_->queue_latency.record(to_nanoseconds(start - task.posted));
+  task.runnable();
+  record_run(task.from, start);
+}
+
+void RunLoop::record_run(Location from, time_point_t start) noexcept {
+  const auto duration = clock_t::now() - start;
+  stats_->run_duration.record(to_nanoseconds(duration));
+
+  auto& slowest = stats_->slowest;
+  if (slowest.size() == Stats::kSlowestCount) {
+    if (duration <= slowest.back().duration)
+      return;
+    slowest.pop_back();
+  }
+  // Doesn't allocate, the capacity is reserved.
+  const auto position = std::upper_bound(
+      slowest.begin(), slowest.end(), duration,
+      [](duration_t duration, const Stats::SlowTask& task) {
+        return duration > task.duration;
+      });
+  slowest.insert(position, Stats::SlowTask{from, duration});
+}
+
+bool RunLoop::wait_fds(std::optional<time_point_t> deadline, bool instrumented) {
+  int timeout_ms = -1;
+  if (deadline) {
+    const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(
+        *deadline - clock_t::now());
+    timeout_ms = static_cast<int>(std::max<std::chrono::milliseconds::rep>(
+        timeout.count(), 0));
+  }
+
+  constexpr int kMaxEvents = 16;
+  epoll_event events[kMaxEvents];
+  const auto wait_start = instrumented ? clock_t::now() : time_point_t{};
+  const int count = ::epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+  if (instrumented) {
+    stats_->idle_time += clock_t::now() - wait_start;
+  }
+  if (count == -1) {
+    ASSERT(errno == EINTR) << "epoll_wait failed: " << errno;
+    return false;
+  }
+
+  bool did_work = false;
+  for (int i = 0; i < count; ++i) {
+    const int fd = events[i].data.fd;
+    if (fd == wakeup_fd_) {
+      uint64_t value;
+      MARK_UNUSED(::read(wakeup_fd_, &value, sizeof(value)));
+      // Something is posted or exit is requested, check that out.
+      did_work = true;
+      continue;
+    }
+
+    auto it = fd_watches_.find(fd);
+    auto watch = it != fd_watches_.end() ? it->second.lock() : nullptr;
+    if (!watch) {
+      // The watch is released, stop watching.
+      ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+      if (it != fd_watches_.end())
+        fd_watches_.erase(it);
+      continue;
+    }
+    if (instrumented) {
+      const auto start = clock_t::now();
+      watch->callback();
+      record_run(watch->from, start);
+    } else {
+      watch->callback();
+    }
+    did_work = true;
+  }
+  return did_work;
+}
+
+void RunLoop::wake_up() noexcept {
+  const uint64_t value = 1;
+  MARK_UNUSED(::write(wakeup_fd_, &value, sizeof(value)));
+}
+
+void RunLoop::notify() noexcept {
+  std::atomic_thread_fence(std::memory_order::seq_cst);
+  if (sleeping_.load(std::memory_order::relaxed) &&
+      sleeping_.exchange(false, std::memory_order::relaxed)) {
+    wake_up();
+  }
+}
+
 void RunLoop::exit_when_idle() noexcept {
   exit_when_idle_ = true;
+  wake_up();
 }
 
-void RunLoop::post(task_t task) noexcept {
-  const auto index = queue_index();
-  auto* queue = acquire_queue(index);
-  queue->tasks.emplace_back(std::move(task));
-  store_queue(queue, index);
+void RunLoop::post(task_t task, Priority priority, Location from) noexcept {
+  const auto posted = instrumentation_enabled() ? clock_t::now() : time_point_t{};
+  producer().push(Task{std::move(task), priority, from, posted});
+  notify();
 }
 
-auto RunLoop::post_delayed(task_t task, duration_t delay) noexcept -> base::ref_ptr<DelayedTask> {
+auto RunLoop::post_delayed(task_t task, duration_t delay, Priority priority,
+                           Location from) noexcept -> base::ref_ptr<DelayedTask> {
   auto delayed_task = base::make_ref_ptr<DelayedTask>(
-      std::move(task), clock_t::now() + delay);
+      std::move(task), clock_t::now() + delay, priority, from);
   const auto index = queue_index();
   auto* queue = acquire_queue(index);
   queue->delayed_tasks.emplace_back(delayed_task);
   store_queue(queue, index);
+  notify();
   return delayed_task;
 }
 
+auto RunLoop::watch_fd(int fd, callback_t callback, Location from)
+    -> base::ref_ptr<FdWatch> {
+  auto watch = base::make_ref_ptr<FdWatch>(fd, std::move(callback), from);
+  epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+  // The fd may still be registered, if its previous watch is released, but has not
+  // fired since.
+  if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1 &&
+      (errno != EEXIST || ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) == -1)) {
+    throw base::system_exception("epoll_ctl failed");
+  }
+  fd_watches_[fd] = base::weak_ref<FdWatch>(watch);
+  return watch;
+}
+
+void RunLoop::set_instrumentation_enabled(bool enabled) {
+  if (enabled && !stats_) {
+    stats_ = std::make_unique<Stats>();
+    stats_->slowest.reserve(Stats::kSlowestCount);
+  }
+  instrumented_.store(enabled, std::memory_order::relaxed);
+}
+
+void RunLoop::reset_stats() noexcept {
+  if (!stats_)
+    return;
+  stats_->queue_latency.reset();
+  stats_->run_duration.reset();
+  stats_->ready_tasks.reset();
+  stats_->busy_time = {};
+  stats_->idle_time = {};
+  stats_->iterations = 0;
+  stats_->slowest.clear();
+}
+
+void RunLoop::dump_stats(std::ostream& out) const {
+  if (!stats_)
+    return;
+  const auto ms = [](duration_t duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+  const auto total = stats_->busy_time + stats_->idle_time;
+  out << "RunLoop stats: iterations=" << stats_->iterations
+      << " busy=" << ms(stats_->busy_time) << "ms idle=" << ms(stats_->idle_time) << "ms";
+  if (total.count() > 0)
+    out << " (" << 100.0 * ms(stats_->busy_time) / ms(total) << "% busy)";
+  out << "\n  queue latency, us: ";
+  stats_->queue_latency.print(out, 1000.0);
+  out << "\n  run duration, us: ";
+  stats_->run_duration.print(out, 1000.0);
+  out << "\n  ready tasks: ";
+  stats_->ready_tasks.print(out);
+  out << "\n  slowest:";
+  for (const auto& task : stats_->slowest) {
+    out << "\n    " << ms(task.duration) << "ms " << task.from.file_name() << ':'
+        << task.from.line() << ' ' << task.from.function_name();
+  }
+  out << '\n';
+}
+
 // static
 RunLoop& RunLoop::current() noexcept {
   ASSERT(!tl_run_loops.empty()) << "No current RunLoop";
@@ -161,7 +597,7 @@ RunLoop& RunLoop::main() noexcept {
 // static
 void RunLoop::set_main(RunLoop* main_loop) noexcept {
   auto* old = g_main_loop.exchange(main_loop, std::memory_order::release);
-  ASSERT(!old) << "Main RunLoop already set";
+  ASSERT(!old || !main_loop) << "Main RunLoop already set";
 }
 
 }  // namespace base
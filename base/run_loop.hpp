@@ -15,19 +15,33 @@
 
 #pragma once
 
+#include "base/histogram.hpp"
+#include "base/location.hpp"
 #include "base/macro.hpp"
 #include "base/ref_ptr.hpp"
+#include "base/unique_function.hpp"
 #include "base/weak_ref.hpp"
 
 #include "base/config.hpp"
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
-#include <functional>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace base {
 
+namespace internal {
+class RunLoopProducer;
+}  // namespace internal
+
 class BASE_PUBLIC RunLoop {
  public:
   DISABLE_COPY_MOVE(RunLoop);
@@ -35,17 +49,70 @@ class BASE_PUBLIC RunLoop {
   using clock_t = std::chrono::steady_clock;
   using duration_t = clock_t::duration;
   using time_point_t = clock_t::time_point;
-  using task_t = std::function<void()>;
+  using task_t = base::OnceTask;
+  // Called over and over again, unlike the `task_t`.
+  using callback_t = base::UniqueFunction<void()>;
+
+  static constexpr std::chrono::milliseconds kTimerSlack{1};
+  // The longest the idle tasks run in a row, when there is no frame deadline.
+  static constexpr std::chrono::milliseconds kIdleTimeSlice{4};
+
+  // Ready tasks of a higher priority run first. The idle ones only run while there
+  // is time left before the frame deadline.
+  enum class Priority {
+    INPUT,
+    FRAME,
+    NORMAL,
+    IDLE,
+  };
+  static constexpr auto kPrioritiesCount = 4;
 
   struct Task {
-    const task_t runnable;
+    task_t runnable;
+    Priority priority;
+    Location from;
+    // Only set while the instrumentation is enabled.
+    time_point_t posted;
   };
 
   struct DelayedTask : public base::WeakReferencedThreadSafe {
-    const task_t runnable;
+    task_t runnable;
     const time_point_t time;
-    explicit DelayedTask(task_t runnable, time_point_t time) noexcept 
-      : runnable(runnable), time(time) {}
+    const Priority priority;
+    const Location from;
+    explicit DelayedTask(task_t runnable, time_point_t time, Priority priority,
+                         Location from) noexcept
+      : runnable(std::move(runnable)), time(time), priority(priority), from(from) {}
+  };
+
+  struct FdWatch : public base::WeakReferencedThreadSafe {
+    const int fd;
+    const callback_t callback;
+    const Location from;
+    explicit FdWatch(int fd, callback_t callback, Location from) noexcept
+      : fd(fd), callback(std::move(callback)), from(from) {}
+  };
+
+  // Collected while the instrumentation is enabled.
+  struct Stats {
+    struct SlowTask {
+      Location from;
+      duration_t duration;
+    };
+    static constexpr std::size_t kSlowestCount = 8;
+
+    // From posting (or the deadline, for the delayed ones) till the task runs, in ns.
+    Histogram queue_latency;
+    // Of the tasks and the fd callbacks, in ns.
+    Histogram run_duration;
+    // Tasks, ready to run at once.
+    Histogram ready_tasks;
+    duration_t busy_time{};
+    // Spent sleeping.
+    duration_t idle_time{};
+    std::uint64_t iterations = 0;
+    // The slowest first.
+    std::vector<SlowTask> slowest;
   };
 
   RunLoop() noexcept;
@@ -57,31 +124,111 @@ class BASE_PUBLIC RunLoop {
   bool exit_requested() const noexcept { return exit_when_idle_; }
   bool running() const noexcept { return running_; }
 
-  void run(task_t on_idle);
-  void post(task_t task) noexcept;
-  NODISCARD base::ref_ptr<DelayedTask> post_delayed(task_t task, duration_t delay) noexcept;
+  // Without `on_idle` the loop sleeps, when there is nothing to do, until a task is
+  // posted, a delayed task is due or a watched fd is ready. Otherwise `on_idle` is
+  // called over and over again while the loop is idle, and the loop never sleeps.
+  void run(callback_t on_idle = {});
+  // Each posting thread gets its own queue in the loop, so posting doesn't contend
+  // with the other threads and is wait-free, unless the queue has to grow.
+  void post(task_t task, Priority priority = Priority::NORMAL,
+            Location from = Location::current()) noexcept;
+  // The task runs no earlier than after `delay`, unless the returned handle is
+  // released before that. Deadlines within the same `kTimerSlack` window are
+  // coalesced into a single wakeup.
+  NODISCARD base::ref_ptr<DelayedTask> post_delayed(
+      task_t task, duration_t delay, Priority priority = Priority::NORMAL,
+      Location from = Location::current()) noexcept;
+
+  // When the next frame is due, if any. The idle tasks yield to it, except for one
+  // task per loop iteration, when there is nothing else to do. Must be set on the
+  // thread, running the loop.
+  void set_frame_deadline(std::optional<time_point_t> deadline) noexcept {
+    frame_deadline_ = deadline;
+  }
+
+  // Runs `callback` on the loop whenever the `fd` is ready for reading, until the
+  // returned handle is released. Must be called on the thread, running the loop.
+  NODISCARD base::ref_ptr<FdWatch> watch_fd(
+      int fd, callback_t callback, Location from = Location::current()) /* may throw */;
+
+  // Called each time the loop runs out of work and is about to sleep. While there are
+  // idle tasks queued, it's called before them, at most once per `kIdleTimeSlice`.
+  // Tasks posted from it are run before sleeping. Must be set on the thread, running
+  // the loop.
+  void set_before_sleep(callback_t before_sleep) noexcept {
+    before_sleep_ = std::move(before_sleep);
+  }
+
+  // The instrumentation costs a couple of clock reads per task, and nothing but a flag
+  // check while disabled. Must be toggled on the thread, running the loop; `stats()`
+  // and `dump_stats()` too - they are `nullptr` and no-op, if it was never enabled.
+  void set_instrumentation_enabled(bool enabled) /* may throw */;
+  GETTER bool instrumentation_enabled() const noexcept {
+    return instrumented_.load(std::memory_order::relaxed);
+  }
+  GETTER const Stats* stats() const noexcept { return stats_.get(); }
+  void reset_stats() noexcept;
+  void dump_stats(std::ostream& out) const;
 
   static RunLoop& current() noexcept;
   static RunLoop& main() noexcept;
+  // Set once, and reset with `nullptr` before the loop is gone.
   static void set_main(RunLoop* loop) noexcept;
 
  private:
   static constinit const auto kQueuesCount = 4;
   struct queue_t {
-    std::vector<Task> tasks;
     std::vector<base::weak_ref<DelayedTask>> delayed_tasks;
   };
+  // Taken from a producer at once at most, so a busy one doesn't hog the loop.
+  static constexpr std::size_t kMaxTasksPerProducer = 4096;
 
   static std::size_t queue_index() noexcept;
   queue_t* acquire_queue(std::size_t index) noexcept;
   void store_queue(queue_t*, std::size_t index) noexcept;
-
+  bool has_tasks() noexcept;
+
+  // The calling thread's queue in this loop.
+  internal::RunLoopProducer& producer() noexcept;
+  // Moves the posted tasks to `tasks`. Loop thread only.
+  void take_posted_tasks(std::array<std::vector<Task>, kPrioritiesCount>& tasks) noexcept;
+
+  // Waits for the watched fds up to the `deadline` (forever, if not set) and runs the
+  // callbacks of the ready ones. Returns `true` if any work is done.
+  bool wait_fds(std::optional<time_point_t> deadline, bool instrumented);
+  void run_task(Task& task, bool instrumented);
+  void record_run(Location from, time_point_t start) noexcept;
+  void wake_up() noexcept;
+  // Wakes the loop up, only if it is sleeping (or about to).
+  void notify() noexcept;
+
+  // Tells the loops apart in the threads' producer lists, unlike the addresses.
+  const std::uint64_t id_;
   std::array<queue_t, kQueuesCount> queues_;
   std::array<std::atomic<queue_t*>, kQueuesCount> queue_ptrs_;
 
+  std::mutex new_producers_mutex_;
+  std::vector<std::shared_ptr<internal::RunLoopProducer>> new_producers_;
+  std::atomic<bool> has_new_producers_;
+  // Loop thread only.
+  std::vector<std::shared_ptr<internal::RunLoopProducer>> producers_;
+
   std::atomic<bool> exit_when_idle_;
   std::atomic<bool> running_;
+  // Set while the loop is in (or about to enter) `epoll_wait` with a timeout, so
+  // posters only pay for the `wakeup_fd_` write when it is needed.
+  std::atomic<bool> sleeping_;
   bool idle_;
+
+  int epoll_fd_;
+  // Written to wake the loop up from `epoll_wait`.
+  int wakeup_fd_;
+  std::unordered_map<int, base::weak_ref<FdWatch>> fd_watches_;
+  callback_t before_sleep_;
+  std::optional<time_point_t> frame_deadline_;
+
+  std::atomic<bool> instrumented_;
+  std::unique_ptr<Stats> stats_;
 };
 
 }  // namespace base
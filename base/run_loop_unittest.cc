@@ -19,6 +19,10 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -156,3 +160,221 @@ TEST_F(RunLoopTest, SequentialConsistency) {
     }
   }
 }
+
+TEST_F(RunLoopTest, SleepingLoopWakesUpOnPost) {
+  base::RunLoop loop{};
+  Dummy dummy;
+
+  EXPECT_CALL(dummy, act).Times(1);
+
+  std::thread thread([&loop]() { loop.run(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  loop.post([&]() {
+    dummy.act();
+    loop.exit_when_idle();
+  });
+  thread.join();
+}
+
+TEST_F(RunLoopTest, SleepingLoopNeverMissesPost) {
+  constexpr int kRoundTrips = 2000;
+  base::RunLoop loop{};
+  std::thread thread([&loop]() { loop.run(); });
+
+  // Each post races with the loop going to sleep after the previous one; a lost
+  // wakeup hangs the test.
+  std::atomic<int> done = 0;
+  for (int i = 0; i < kRoundTrips; ++i) {
+    loop.post([&done]() {
+      done.fetch_add(1, std::memory_order::release);
+      done.notify_one();
+    });
+    done.wait(i, std::memory_order::acquire);
+  }
+  EXPECT_EQ(done.load(), kRoundTrips);
+
+  loop.exit_when_idle();
+  thread.join();
+}
+
+TEST_F(RunLoopTest, RunsTasksOfExitedThreads) {
+  // More than fits in one ring of the thread's queue.
+  constexpr int kTasks = 1000;
+  base::RunLoop loop{};
+
+  std::vector<int> order;
+  std::thread thread([&]() {
+    for (int i = 0; i < kTasks; ++i) {
+      loop.post([&order, i]() { order.push_back(i); });
+    }
+  });
+  thread.join();
+
+  loop.post([&loop]() { loop.exit_when_idle(); });
+  loop.run();
+
+  ASSERT_EQ(order.size(), kTasks);
+  for (int i = 0; i < kTasks; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST_F(RunLoopTest, DelayedTasksRunInDeadlineOrder) {
+  using namespace std::chrono_literals;
+  base::RunLoop loop{};
+  std::vector<int> order;
+
+  auto t3 = loop.post_delayed([&]() { order.push_back(3); }, 30ms);
+  auto t1 = loop.post_delayed([&]() { order.push_back(1); }, 10ms);
+  auto cancelled = loop.post_delayed([&]() { order.push_back(-1); }, 5ms);
+  auto t2 = loop.post_delayed([&]() { order.push_back(2); }, 20ms);
+  auto t2_too = loop.post_delayed([&]() { order.push_back(22); }, 20ms);
+  auto exit = loop.post_delayed([&]() { loop.exit_when_idle(); }, 40ms);
+  cancelled = nullptr;
+
+  loop.run();
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 22, 3}));
+}
+
+TEST_F(RunLoopTest, CancelledDelayedTasksDontWakeUp) {
+  using namespace std::chrono_literals;
+  base::RunLoop loop{};
+  std::vector<base::ref_ptr<base::RunLoop::DelayedTask>> cancelled;
+  base::ref_ptr<base::RunLoop::DelayedTask> exit;
+
+  loop.post([&]() {
+    loop.set_instrumentation_enabled(true);
+    for (int i = 1; i <= 20; ++i)
+      cancelled.push_back(loop.post_delayed([]() { FAIL(); }, i * 2ms));
+    exit = loop.post_delayed([&]() { loop.exit_when_idle(); }, 50ms);
+    // Runs once the timers are in the heap.
+    loop.post([&]() { cancelled.clear(); });
+  });
+  loop.run();
+
+  // Without dropping the cancelled timers, the loop would wake up for each of them.
+  EXPECT_LT(loop.stats()->iterations, 10u);
+}
+
+TEST_F(RunLoopTest, RunsHigherPrioritiesFirst) {
+  using Priority = base::RunLoop::Priority;
+  base::RunLoop loop{};
+  std::vector<Priority> order;
+
+  for (auto priority : {Priority::IDLE, Priority::NORMAL, Priority::FRAME, Priority::INPUT}) {
+    loop.post([&order, priority]() { order.push_back(priority); }, priority);
+  }
+  loop.exit_when_idle();
+  loop.run();
+
+  EXPECT_EQ(order, (std::vector<Priority>{Priority::INPUT, Priority::FRAME,
+                                          Priority::NORMAL, Priority::IDLE}));
+}
+
+TEST_F(RunLoopTest, IdleTasksYieldToOtherWorkPastFrameDeadline) {
+  using Priority = base::RunLoop::Priority;
+  base::RunLoop loop{};
+  std::vector<std::string> order;
+
+  loop.post([&]() {
+    // Only one idle task per iteration from now on, and only if nothing else is done.
+    loop.set_frame_deadline(base::RunLoop::clock_t::now());
+    for (int i = 0; i < 3; ++i) {
+      loop.post([&, i]() {
+        order.push_back("idle" + std::to_string(i));
+        if (i == 0)
+          loop.post([&]() { order.push_back("normal"); });
+      }, Priority::IDLE);
+    }
+  });
+  auto exit = loop.post_delayed([&]() { loop.exit_when_idle(); },
+                                std::chrono::milliseconds{10});
+  loop.run();
+
+  EXPECT_EQ(order, (std::vector<std::string>{"idle0", "normal", "idle1", "idle2"}));
+}
+
+TEST_F(RunLoopTest, BeforeSleepRunsOncePerIdleSlice) {
+  using Priority = base::RunLoop::Priority;
+  base::RunLoop loop{};
+  int before_sleep_calls = 0;
+  int idle_runs = 0;
+  loop.set_before_sleep([&]() { ++before_sleep_calls; });
+
+  loop.post([&]() {
+    // One idle task per iteration.
+    loop.set_frame_deadline(base::RunLoop::clock_t::now());
+    for (int i = 0; i < 100; ++i)
+      loop.post([&]() { ++idle_runs; }, Priority::IDLE);
+  });
+  loop.exit_when_idle();
+  const auto start = base::RunLoop::clock_t::now();
+  loop.run();
+  const auto slices = (base::RunLoop::clock_t::now() - start) /
+                      base::RunLoop::kIdleTimeSlice;
+
+  EXPECT_EQ(idle_runs, 100);
+  // At the start of each slice and once before exiting.
+  EXPECT_LE(before_sleep_calls, slices + 2);
+}
+
+TEST_F(RunLoopTest, Instrumentation) {
+  base::RunLoop loop{};
+  EXPECT_EQ(loop.stats(), nullptr);
+
+  base::ref_ptr<base::RunLoop::DelayedTask> exit;
+  loop.post([&]() {
+    loop.set_instrumentation_enabled(true);
+    loop.post([]() { std::this_thread::sleep_for(std::chrono::milliseconds{2}); });
+    loop.post([]() {});
+    exit = loop.post_delayed([&]() { loop.exit_when_idle(); },
+                             std::chrono::milliseconds{5});
+  });
+  loop.run();
+
+  const auto* stats = loop.stats();
+  ASSERT_NE(stats, nullptr);
+  EXPECT_EQ(stats->queue_latency.count(), 3u);
+  EXPECT_EQ(stats->run_duration.count(), 3u);
+  EXPECT_GE(stats->run_duration.max(), 2'000'000u);
+  EXPECT_GT(stats->iterations, 0u);
+  EXPECT_GT(stats->idle_time.count(), 0);
+  ASSERT_FALSE(stats->slowest.empty());
+  EXPECT_NE(std::string(stats->slowest.front().from.file_name()).find("run_loop_unittest"),
+            std::string::npos);
+
+  std::ostringstream dump;
+  loop.dump_stats(dump);
+  EXPECT_NE(dump.str().find("run duration"), std::string::npos);
+
+  loop.reset_stats();
+  EXPECT_EQ(loop.stats()->run_duration.count(), 0u);
+}
+
+TEST_F(RunLoopTest, WatchFd) {
+  base::RunLoop loop{};
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  std::string received;
+  auto watch = loop.watch_fd(fds[0], [&]() {
+    char buffer[8];
+    auto size = read(fds[0], buffer, sizeof(buffer));
+    received.append(buffer, size);
+    if (received == "ping")
+      loop.exit_when_idle();
+  });
+
+  std::thread writer([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    ASSERT_EQ(write(fds[1], "pi", 2), 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    ASSERT_EQ(write(fds[1], "ng", 2), 2);
+  });
+  loop.run();
+  writer.join();
+
+  EXPECT_EQ(received, "ping");
+  close(fds[0]);
+  close(fds[1]);
+}
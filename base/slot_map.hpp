@@ -0,0 +1,108 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/macro.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+// Stores the values in a vector of slots, and gives out keys to them: the slot index
+// along with the slot's generation, which is bumped whenever the slot is freed. So a
+// key to an erased value never finds the value, which has reused its slot, and every
+// lookup is just an index and a comparison.
+template <class T>
+class SlotMap {
+ public:
+  struct Key {
+    std::uint32_t index = kNoIndex;
+    std::uint32_t generation = 0;
+
+    bool operator==(const Key&) const noexcept = default;
+  };
+
+  SlotMap() = default;
+
+  GETTER bool empty() const noexcept { return size_ == 0; }
+  GETTER std::size_t size() const noexcept { return size_; }
+
+  Key insert(T value) /* may throw */ {
+    std::uint32_t index;
+    if (free_head_ != kNoIndex) {
+      index = free_head_;
+      free_head_ = slots_[index].next_free;
+    } else {
+      index = static_cast<std::uint32_t>(slots_.size());
+      slots_.emplace_back();
+    }
+    auto& slot = slots_[index];
+    slot.value.emplace(std::move(value));
+    ++size_;
+    return Key{index, slot.generation};
+  }
+
+  // Returns `false` if the key is stale.
+  bool erase(Key key) noexcept {
+    auto* slot = find(key);
+    if (!slot)
+      return false;
+    slot->value.reset();
+    // Zero is skipped, so the default key never matches.
+    if (++slot->generation == 0)
+      slot->generation = 1;
+    slot->next_free = free_head_;
+    free_head_ = key.index;
+    --size_;
+    return true;
+  }
+
+  GETTER T* get(Key key) noexcept {
+    auto* slot = find(key);
+    return slot ? &*slot->value : nullptr;
+  }
+  GETTER const T* get(Key key) const noexcept {
+    return const_cast<SlotMap*>(this)->get(key);
+  }
+  GETTER bool contains(Key key) const noexcept { return get(key) != nullptr; }
+
+ private:
+  static constexpr auto kNoIndex = std::numeric_limits<std::uint32_t>::max();
+
+  struct Slot {
+    std::optional<T> value;
+    std::uint32_t generation = 1;
+    std::uint32_t next_free = kNoIndex;
+  };
+
+  Slot* find(Key key) noexcept {
+    if (key.index >= slots_.size())
+      return nullptr;
+    auto& slot = slots_[key.index];
+    return slot.generation == key.generation && slot.value ? &slot : nullptr;
+  }
+
+  std::vector<Slot> slots_;
+  std::uint32_t free_head_ = kNoIndex;
+  std::size_t size_ = 0;
+};
+
+}  // namespace base
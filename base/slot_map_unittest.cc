@@ -0,0 +1,55 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/slot_map.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+TEST(SlotMapTest, InsertGetErase) {
+  base::SlotMap<std::string> map;
+  const auto a = map.insert("a");
+  const auto b = map.insert("b");
+
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(*map.get(a), "a");
+  EXPECT_EQ(*map.get(b), "b");
+
+  EXPECT_TRUE(map.erase(a));
+  EXPECT_FALSE(map.erase(a));
+  EXPECT_EQ(map.get(a), nullptr);
+  EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(SlotMapTest, StaleKeyDoesNotSeeReusedSlot) {
+  base::SlotMap<int> map;
+  const auto old_key = map.insert(1);
+  map.erase(old_key);
+  const auto new_key = map.insert(2);
+
+  EXPECT_EQ(new_key.index, old_key.index);
+  EXPECT_NE(new_key, old_key);
+  EXPECT_FALSE(map.contains(old_key));
+  EXPECT_EQ(*map.get(new_key), 2);
+}
+
+TEST(SlotMapTest, DefaultKeyIsInvalid) {
+  base::SlotMap<int> map;
+  map.insert(1);
+
+  EXPECT_FALSE(map.contains({}));
+  EXPECT_FALSE(map.erase({}));
+}
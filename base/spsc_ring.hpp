@@ -0,0 +1,107 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/macro.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace base {
+
+// Fixed-size lock-free ring buffer for exactly one producer and one consumer thread.
+// Neither side takes locks or allocates.
+template <class T, std::size_t Capacity>
+class SpscRing {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+ public:
+  SpscRing() noexcept = default;
+  ~SpscRing() noexcept {
+    while (try_pop()) {
+    }
+  }
+
+  DISABLE_COPY_MOVE(SpscRing);
+
+  // Producer side. Returns `false` if the ring is full.
+  template <class... Args>
+  bool try_emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_cache_ == Capacity) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head - tail_cache_ == Capacity)
+        return false;
+    }
+    new (slot(head)) T(std::forward<Args>(args)...);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(T value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    return try_emplace(std::move(value));
+  }
+
+  // Consumer side. Returns nothing if the ring is empty.
+  std::optional<T> try_pop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_cache_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail == head_cache_)
+        return {};
+    }
+    auto* item = std::launder(reinterpret_cast<T*>(slot(tail)));
+    std::optional<T> value{std::move(*item)};
+    item->~T();
+    tail_.store(tail + 1, std::memory_order_release);
+    return value;
+  }
+
+  // Exact only if the other side is idle.
+  GETTER std::size_t size() const noexcept {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  GETTER bool empty() const noexcept { return size() == 0; }
+  GETTER static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+ private:
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  struct alignas(T) Slot {
+    std::byte data[sizeof(T)];
+  };
+
+  void* slot(std::size_t index) noexcept { return &storage_[index & (Capacity - 1)]; }
+
+  // The indices only grow, the slot is the index modulo capacity. Each side's index
+  // lives on its own cache line along with its cached copy of the other side's index,
+  // so the sides don't contend unless the ring looks full or empty.
+  alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+  std::size_t tail_cache_ = 0;
+
+  alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+  std::size_t head_cache_ = 0;
+
+  alignas(kCacheLineSize) std::array<Slot, Capacity> storage_;
+};
+
+}  // namespace base
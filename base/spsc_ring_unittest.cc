@@ -0,0 +1,83 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/spsc_ring.hpp"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <thread>
+
+TEST(SpscRingTest, PopsInOrder) {
+  base::SpscRing<int, 4> ring;
+  EXPECT_FALSE(ring.try_pop());
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(ring.try_push(i));
+    ASSERT_TRUE(ring.try_push(i + 100));
+    EXPECT_EQ(ring.try_pop(), i);
+    EXPECT_EQ(ring.try_pop(), i + 100);
+  }
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, RejectsWhenFull) {
+  base::SpscRing<int, 2> ring;
+  EXPECT_TRUE(ring.try_push(1));
+  EXPECT_TRUE(ring.try_push(2));
+  EXPECT_FALSE(ring.try_push(3));
+  EXPECT_EQ(ring.size(), 2u);
+
+  EXPECT_EQ(ring.try_pop(), 1);
+  EXPECT_TRUE(ring.try_push(3));
+  EXPECT_EQ(ring.try_pop(), 2);
+  EXPECT_EQ(ring.try_pop(), 3);
+}
+
+TEST(SpscRingTest, DestroysItems) {
+  auto item = std::make_shared<int>(0);
+  {
+    base::SpscRing<std::shared_ptr<int>, 4> ring;
+    ring.try_push(item);
+    ring.try_push(item);
+    EXPECT_EQ(item.use_count(), 3);
+
+    ring.try_pop();
+    EXPECT_EQ(item.use_count(), 2);
+  }
+  EXPECT_EQ(item.use_count(), 1);
+}
+
+TEST(SpscRingTest, ProducerAndConsumerThreads) {
+  constexpr int kCount = 100000;
+  base::SpscRing<int, 64> ring;
+
+  std::thread producer([&ring]() {
+    for (int i = 0; i < kCount; ++i) {
+      while (!ring.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (int expected = 0; expected < kCount;) {
+    if (auto value = ring.try_pop()) {
+      ASSERT_EQ(*value, expected++);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
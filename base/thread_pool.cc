@@ -0,0 +1,154 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/thread_pool.hpp"
+
+#include "base/debug/debug.hpp"
+#include "base/epoch.hpp"
+#include "base/run_loop.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace base {
+
+namespace {
+struct CurrentWorker {
+  const ThreadPool* pool;
+  std::size_t index;
+};
+thread_local CurrentWorker tl_current_worker{nullptr, 0};
+}  // namespace
+
+struct ThreadPool::Worker {
+  WorkStealingDeque<Job*> deque;
+  std::thread thread;
+};
+
+ThreadPool::ThreadPool(std::size_t workers)
+    : workers_{}
+    , injected_mutex_{}
+    , injected_{}
+    , injected_count_{0}
+    , work_epoch_{0}
+    , sleepers_{0}
+    , stopping_{false} {
+  if (workers == 0)
+    workers = std::max(std::thread::hardware_concurrency(), 1u);
+
+  // All the deques must exist before any worker starts stealing.
+  workers_.reserve(workers);
+  for (auto i = 0u; i < workers; ++i) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  for (auto i = 0u; i < workers; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { worker_routine(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+  stopping_.store(true, std::memory_order::release);
+  work_epoch_.fetch_add(1, std::memory_order::seq_cst);
+  work_epoch_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+  ASSERT(injected_.empty()) << "Tasks left unrun";
+}
+
+void ThreadPool::post(task_t task) {
+  auto job = std::make_unique<Job>(Job{std::move(task)});
+  if (tl_current_worker.pool == this) {
+    workers_[tl_current_worker.index]->deque.push(job.get());
+  } else {
+    std::lock_guard lock{injected_mutex_};
+    injected_.push_back(job.get());
+    injected_count_.fetch_add(1, std::memory_order::relaxed);
+  }
+  job.release();
+  notify();
+}
+
+void ThreadPool::post_task_and_reply(task_t task, task_t reply, Location from) {
+  auto* origin = &RunLoop::current();
+  post([task = std::move(task), reply = std::move(reply), origin, from]() mutable {
+    task();
+    origin->post(std::move(reply), RunLoop::Priority::NORMAL, from);
+  });
+}
+
+void ThreadPool::notify() noexcept {
+  // Pairs with the `sleepers_` increment in `worker_routine()`: either the worker
+  // sees the new epoch and doesn't sleep, or it's seen here and woken up.
+  work_epoch_.fetch_add(1, std::memory_order::seq_cst);
+  if (sleepers_.load(std::memory_order::seq_cst) > 0) {
+    work_epoch_.notify_one();
+  }
+}
+
+void ThreadPool::worker_routine(std::size_t index) noexcept {
+  tl_current_worker = {this, index};
+  std::uint32_t seed = static_cast<std::uint32_t>(index) * 2654435761u + 1;
+
+  while (true) {
+    const auto epoch = work_epoch_.load(std::memory_order::seq_cst);
+    if (auto* job = find_job(index, seed)) {
+      std::unique_ptr<Job>(job)->task();
+      continue;
+    }
+    if (stopping_.load(std::memory_order::acquire))
+      break;
+
+    // Idle is a quiescent point, the grown deques' arrays may be freed.
+    epoch_reclaim();
+    sleepers_.fetch_add(1, std::memory_order::seq_cst);
+    work_epoch_.wait(epoch, std::memory_order::seq_cst);
+    sleepers_.fetch_sub(1, std::memory_order::relaxed);
+  }
+  tl_current_worker = {nullptr, 0};
+}
+
+auto ThreadPool::find_job(std::size_t index, std::uint32_t& seed) noexcept -> Job* {
+  if (auto job = workers_[index]->deque.take())
+    return *job;
+
+  if (injected_count_.load(std::memory_order::relaxed) > 0) {
+    std::lock_guard lock{injected_mutex_};
+    if (!injected_.empty()) {
+      auto* job = injected_.front();
+      injected_.pop_front();
+      injected_count_.fetch_sub(1, std::memory_order::relaxed);
+      return job;
+    }
+  }
+
+  // Start from a random victim, so the thieves don't all go after the same one.
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  const auto count = workers_.size();
+  for (auto i = 0u; i < count; ++i) {
+    const auto victim = (seed + i) % count;
+    if (victim == index)
+      continue;
+    if (auto job = workers_[victim]->deque.steal())
+      return *job;
+  }
+  return nullptr;
+}
+
+}  // namespace base
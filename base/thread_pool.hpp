@@ -0,0 +1,95 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/location.hpp"
+#include "base/macro.hpp"
+#include "base/unique_function.hpp"
+#include "base/work_stealing_deque.hpp"
+
+#include "base/config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace base {
+
+// Runs tasks on a fixed set of worker threads. Each worker has its own deque: tasks,
+// posted from a worker, go to its deque, and idle workers steal from the others'.
+// Tasks, posted from other threads, go through a shared queue.
+//
+// Tasks may run after their poster is gone, so they should own (`ref_ptr`) what they
+// work with, and replies should only hold a `weak_ref` to whatever may be destroyed
+// in the meantime.
+class BASE_PUBLIC ThreadPool {
+ public:
+  using task_t = base::OnceTask;
+
+  DISABLE_COPY_MOVE(ThreadPool);
+
+  // Uses `std::thread::hardware_concurrency()` workers, if `workers` is 0.
+  explicit ThreadPool(std::size_t workers = 0) /* may throw */;
+  // Runs all the already posted tasks before returning.
+  ~ThreadPool() noexcept;
+
+  void post(task_t task) /* may throw */;
+
+  // Runs `task` on the pool, then posts `reply` to the `RunLoop::current()` of the
+  // calling thread. The loop must outlive the task.
+  void post_task_and_reply(task_t task, task_t reply,
+                           Location from = Location::current()) /* may throw */;
+
+  template <class R>
+  void post_task_and_reply_with_result(UniqueFunction<R()> task,
+                                       UniqueFunction<void(R)> reply,
+                                       Location from = Location::current()) /* may throw */ {
+    auto result = std::make_shared<std::optional<R>>();
+    post_task_and_reply(
+        [task = std::move(task), result]() { result->emplace(task()); },
+        [reply = std::move(reply), result]() { reply(std::move(**result)); }, from);
+  }
+
+  GETTER std::size_t size() const noexcept { return workers_.size(); }
+
+ private:
+  struct Job {
+    task_t task;
+  };
+  struct Worker;
+
+  void worker_routine(std::size_t index) noexcept;
+  Job* find_job(std::size_t index, std::uint32_t& seed) noexcept;
+  void notify() noexcept;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex injected_mutex_;
+  std::deque<Job*> injected_;
+  std::atomic<std::size_t> injected_count_;
+
+  // Bumped on each post; the idle workers wait on it.
+  std::atomic<std::uint32_t> work_epoch_;
+  std::atomic<std::uint32_t> sleepers_;
+  std::atomic<bool> stopping_;
+};
+
+}  // namespace base
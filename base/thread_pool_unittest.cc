@@ -0,0 +1,86 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/thread_pool.hpp"
+
+#include "base/debug/debug.hpp"
+#include "base/run_loop.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+class ThreadPoolTest : public testing::Test {
+  void SetUp() override { base::debug::setup_logging(&logger_); }
+  base::debug::LoggerToStdErr logger_;
+};
+
+TEST_F(ThreadPoolTest, RunsAllTasks) {
+  constexpr int kTasks = 10000;
+  std::atomic<int> done = 0;
+  {
+    base::ThreadPool pool{4};
+    for (int i = 0; i < kTasks; ++i) {
+      pool.post([&done]() { done.fetch_add(1); });
+    }
+  }
+  EXPECT_EQ(done.load(), kTasks);
+}
+
+TEST_F(ThreadPoolTest, RunsNestedTasks) {
+  constexpr int kTasks = 1000;
+  std::atomic<int> done = 0;
+  {
+    base::ThreadPool pool{4};
+    // The nested tasks land in the worker's own deque and are stolen by the others.
+    pool.post([&]() {
+      for (int i = 0; i < kTasks; ++i) {
+        pool.post([&done]() { done.fetch_add(1); });
+      }
+    });
+  }
+  EXPECT_EQ(done.load(), kTasks);
+}
+
+TEST_F(ThreadPoolTest, RepliesOnOriginLoop) {
+  base::RunLoop loop;
+  base::ThreadPool pool{2};
+  const auto origin = std::this_thread::get_id();
+  std::thread::id task_thread, reply_thread;
+  std::string result;
+  int replies = 0;
+
+  loop.post([&]() {
+    pool.post_task_and_reply([&]() { task_thread = std::this_thread::get_id(); },
+                             [&]() {
+                               reply_thread = std::this_thread::get_id();
+                               if (++replies == 2)
+                                 loop.exit_when_idle();
+                             });
+    pool.post_task_and_reply_with_result<std::string>(
+        []() { return std::string("done"); },
+        [&](std::string value) {
+          result = std::move(value);
+          if (++replies == 2)
+            loop.exit_when_idle();
+        });
+  });
+  loop.run();
+
+  EXPECT_NE(task_thread, origin);
+  EXPECT_EQ(reply_thread, origin);
+  EXPECT_EQ(result, "done");
+}
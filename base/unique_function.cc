@@ -0,0 +1,137 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/unique_function.hpp"
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace base::internal {
+
+namespace {
+
+constexpr std::array<std::size_t, 3> kSizeClasses = {128, 256, 512};
+// Blocks, kept by a thread before it returns half of them to the shared pool.
+constexpr std::size_t kMaxCachedBlocks = 32;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeBlock* head = nullptr;
+  std::size_t size = 0;
+
+  void push(void* ptr) noexcept {
+    head = new (ptr) FreeBlock{head};
+    ++size;
+  }
+
+  void* pop() noexcept {
+    auto* block = head;
+    head = block->next;
+    --size;
+    return block;
+  }
+};
+
+// Shared by all the threads, as the tasks are usually allocated on one thread and
+// freed on another. The blocks are never returned to the system.
+struct SharedPool {
+  std::mutex mutex;
+  FreeList blocks;
+};
+std::array<SharedPool, kSizeClasses.size()> g_shared_pools;
+
+void move_blocks(FreeList& from, FreeList& to, std::size_t count) noexcept {
+  for (; count > 0 && from.head; --count) {
+    to.push(from.pop());
+  }
+}
+
+struct ThreadCache {
+  std::array<FreeList, kSizeClasses.size()> lists;
+  ~ThreadCache() noexcept;
+};
+thread_local ThreadCache tl_cache;
+// The functions, destroyed after the `tl_cache`, go to the shared pool directly.
+thread_local bool tl_cache_alive = true;
+
+ThreadCache::~ThreadCache() noexcept {
+  tl_cache_alive = false;
+  for (auto index = 0u; index < kSizeClasses.size(); ++index) {
+    std::lock_guard lock{g_shared_pools[index].mutex};
+    move_blocks(lists[index], g_shared_pools[index].blocks, lists[index].size);
+  }
+}
+
+int size_class(std::size_t size) noexcept {
+  for (auto index = 0u; index < kSizeClasses.size(); ++index) {
+    if (size <= kSizeClasses[index])
+      return static_cast<int>(index);
+  }
+  return -1;
+}
+
+}  // namespace
+
+void* allocate_function_storage(std::size_t size) {
+  const int index = size_class(size);
+  if (index < 0)
+    return ::operator new(size);
+
+  auto& shared = g_shared_pools[index];
+  if (!tl_cache_alive) {
+    std::lock_guard lock{shared.mutex};
+    if (shared.blocks.head)
+      return shared.blocks.pop();
+    return ::operator new(kSizeClasses[index]);
+  }
+
+  auto& cache = tl_cache.lists[index];
+  if (!cache.head) {
+    std::lock_guard lock{shared.mutex};
+    move_blocks(shared.blocks, cache, kMaxCachedBlocks / 2);
+  }
+  if (cache.head)
+    return cache.pop();
+  return ::operator new(kSizeClasses[index]);
+}
+
+void deallocate_function_storage(void* ptr, std::size_t size) noexcept {
+  const int index = size_class(size);
+  if (index < 0) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  auto& shared = g_shared_pools[index];
+  if (!tl_cache_alive) {
+    std::lock_guard lock{shared.mutex};
+    shared.blocks.push(ptr);
+    return;
+  }
+
+  auto& cache = tl_cache.lists[index];
+  cache.push(ptr);
+  if (cache.size > kMaxCachedBlocks) {
+    std::lock_guard lock{shared.mutex};
+    move_blocks(cache, shared.blocks, kMaxCachedBlocks / 2);
+  }
+}
+
+}  // namespace base::internal
@@ -0,0 +1,182 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/debug/debug.hpp"
+#include "base/macro.hpp"
+
+#include "base/config.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace base {
+
+namespace internal {
+// Pooled storage for the callables too big to be stored inline.
+BASE_PUBLIC void* allocate_function_storage(std::size_t size) /* may throw */;
+BASE_PUBLIC void deallocate_function_storage(void* ptr, std::size_t size) noexcept;
+
+template <class Fn>
+struct is_std_function : std::false_type {};
+template <class Signature>
+struct is_std_function<std::function<Signature>> : std::true_type {};
+
+// Empty ones of these make an empty function.
+template <class Fn>
+constexpr bool is_nullable_callable =
+    std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn> || is_std_function<Fn>::value;
+}  // namespace internal
+
+template <class Signature>
+class UniqueFunction;
+
+// Move-only `std::function` replacement. Callables of up to `kInlineSize` bytes are
+// stored inline, larger ones - in the pooled storage, so in the steady state no
+// callable is allocated with `new`. Like `std::function`, calls the callable
+// through `const` method.
+template <class R, class... Args>
+class UniqueFunction<R(Args...)> {
+ public:
+  static constexpr std::size_t kInlineSize = 48;
+
+  UniqueFunction() noexcept = default;
+  UniqueFunction(std::nullptr_t) noexcept {}
+
+  template <class F>
+    requires(!std::same_as<std::remove_cvref_t<F>, UniqueFunction> &&
+             std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+  UniqueFunction(F&& callable) /* may throw */ {
+    using Fn = std::decay_t<F>;
+    if constexpr (internal::is_nullable_callable<Fn>) {
+      if (!callable)
+        return;
+    }
+
+    if constexpr (stored_inline<Fn>) {
+      new (storage_) Fn(std::forward<F>(callable));
+      ops_ = &kInlineOps<Fn>;
+    } else {
+      static_assert(alignof(Fn) <= alignof(std::max_align_t), "Over-aligned callable");
+      void* ptr = internal::allocate_function_storage(sizeof(Fn));
+      try {
+        new (ptr) Fn(std::forward<F>(callable));
+      } catch (...) {
+        internal::deallocate_function_storage(ptr, sizeof(Fn));
+        throw;
+      }
+      new (storage_) Fn*(static_cast<Fn*>(ptr));
+      ops_ = &kPooledOps<Fn>;
+    }
+  }
+
+  UniqueFunction(UniqueFunction&& other) noexcept { take(other); }
+
+  UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  UniqueFunction& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  UniqueFunction(const UniqueFunction&) = delete;
+  UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+  ~UniqueFunction() noexcept { reset(); }
+
+  explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+  R operator()(Args... args) const {
+    ASSERT(ops_) << "Calling an empty function";
+    return ops_->invoke(const_cast<std::byte*>(storage_), std::forward<Args>(args)...);
+  }
+
+ private:
+  struct Ops {
+    R (*invoke)(void* storage, Args&&... args);
+    // Move-constructs `to` from `from` and destroys `from`.
+    void (*relocate)(void* from, void* to) noexcept;
+    void (*destroy)(void* storage) noexcept;
+  };
+
+  template <class Fn>
+  static constexpr bool stored_inline = sizeof(Fn) <= kInlineSize &&
+                                        alignof(Fn) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<Fn>;
+
+  template <class Fn>
+  static constexpr Ops kInlineOps{
+      .invoke = [](void* storage, Args&&... args) -> R {
+        return std::invoke(*std::launder(static_cast<Fn*>(storage)),
+                           std::forward<Args>(args)...);
+      },
+      .relocate = [](void* from, void* to) noexcept {
+        auto* fn = std::launder(static_cast<Fn*>(from));
+        new (to) Fn(std::move(*fn));
+        fn->~Fn();
+      },
+      .destroy = [](void* storage) noexcept {
+        std::launder(static_cast<Fn*>(storage))->~Fn();
+      },
+  };
+
+  template <class Fn>
+  static constexpr Ops kPooledOps{
+      .invoke = [](void* storage, Args&&... args) -> R {
+        return std::invoke(**std::launder(static_cast<Fn**>(storage)),
+                           std::forward<Args>(args)...);
+      },
+      .relocate = [](void* from, void* to) noexcept {
+        new (to) Fn*(*std::launder(static_cast<Fn**>(from)));
+      },
+      .destroy = [](void* storage) noexcept {
+        auto* fn = *std::launder(static_cast<Fn**>(storage));
+        fn->~Fn();
+        internal::deallocate_function_storage(fn, sizeof(Fn));
+      },
+  };
+
+  void take(UniqueFunction& other) noexcept {
+    if (other.ops_) {
+      other.ops_->relocate(other.storage_, storage_);
+      ops_ = std::exchange(other.ops_, nullptr);
+    }
+  }
+
+  void reset() noexcept {
+    if (auto* ops = std::exchange(ops_, nullptr))
+      ops->destroy(storage_);
+  }
+
+  alignas(std::max_align_t) std::byte storage_[kInlineSize];
+  const Ops* ops_ = nullptr;
+};
+
+// A task, posted to be run once.
+using OnceTask = UniqueFunction<void()>;
+static_assert(sizeof(OnceTask) <= 64, "OnceTask should fit a cache line");
+
+}  // namespace base
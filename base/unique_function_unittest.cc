@@ -0,0 +1,99 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/unique_function.hpp"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(UniqueFunctionTest, CallsInlineAndPooled) {
+  int calls = 0;
+  base::UniqueFunction<int(int)> small = [&calls](int x) {
+    ++calls;
+    return x + 1;
+  };
+  std::array<int, 64> big_capture{};
+  big_capture[63] = 10;
+  base::UniqueFunction<int(int)> big = [&calls, big_capture](int x) {
+    ++calls;
+    return x + big_capture[63];
+  };
+
+  EXPECT_EQ(small(1), 2);
+  EXPECT_EQ(big(1), 11);
+  EXPECT_EQ(calls, 2);
+}
+
+TEST(UniqueFunctionTest, HoldsMoveOnlyCaptures) {
+  auto value = std::make_unique<std::string>("value");
+  base::OnceTask task = [value = std::move(value)]() { value->append("!"); };
+
+  base::OnceTask moved = std::move(task);
+  EXPECT_FALSE(task);
+  ASSERT_TRUE(moved);
+  moved();
+}
+
+TEST(UniqueFunctionTest, DestroysCallables) {
+  auto counter = std::make_shared<int>(0);
+  std::array<char, 200> padding{};
+  {
+    base::OnceTask small = [counter]() {};
+    base::OnceTask big = [counter, padding]() {};
+    EXPECT_EQ(counter.use_count(), 3);
+
+    small = std::move(big);
+    EXPECT_EQ(counter.use_count(), 2);
+    small = nullptr;
+    EXPECT_EQ(counter.use_count(), 1);
+
+    big = [counter]() {};
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(UniqueFunctionTest, EmptyCallablesMakeEmptyFunction) {
+  std::function<void()> empty_function;
+  void (*empty_pointer)() = nullptr;
+  EXPECT_FALSE(base::OnceTask{empty_function});
+  EXPECT_FALSE(base::OnceTask{empty_pointer});
+  EXPECT_FALSE(base::OnceTask{});
+  EXPECT_TRUE(base::OnceTask{[]() {}});
+}
+
+TEST(UniqueFunctionTest, PooledStorageCrossesThreads) {
+  constexpr int kTasks = 1000;
+  std::array<char, 100> padding{};
+  int done = 0;
+  std::vector<base::OnceTask> tasks;
+  std::thread producer([&]() {
+    for (int i = 0; i < kTasks; ++i) {
+      tasks.emplace_back([&done, padding]() { done += 1 + padding[0]; });
+    }
+  });
+  producer.join();
+
+  for (auto& task : tasks) {
+    task();
+  }
+  tasks.clear();
+  EXPECT_EQ(done, kTasks);
+}
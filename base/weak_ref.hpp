@@ -201,6 +201,12 @@ class weak_ref final : public internal::weak_ref_base_for<T> {
     return ref_ptr<T>(ptr);
   }
 
+  // Unlike `lock()`, doesn't take a reference. Works for the thread safe objects too,
+  // for which `== nullptr` isn't available.
+  bool expired() const noexcept {
+    return !base::control_block_ || base::control_block_->is_ptr_null();
+  }
+
   bool operator==(const weak_ref& other) const noexcept {
     return base::control_block_ == other.control_block_;
   }
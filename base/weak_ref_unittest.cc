@@ -40,6 +40,8 @@ class ObjectWithDestroyAndWeak : public base::WeakReferenced {
 
 class Object : public base::WeakReferenced {};
 
+class ThreadSafeObject : public base::WeakReferencedThreadSafe {};
+
 class DerivedObject : public Object {
  public:
   ~DerivedObject() override = default;
@@ -183,3 +185,16 @@ TEST(WeakRefTest, ConstTest) {
   auto rp = base::make_ref_ptr<const Object>();
   auto wp = base::weak_ref(rp);
 }
+
+TEST(WeakRefTest, Expired) {
+  EXPECT_TRUE(base::weak_ref<ThreadSafeObject>().expired());
+
+  auto rp = base::make_ref_ptr<ThreadSafeObject>();
+  auto wp = base::weak_ref(rp);
+  EXPECT_FALSE(wp.expired());
+
+  rp = nullptr;
+  EXPECT_TRUE(wp.expired());
+  // Compares the control blocks instead.
+  EXPECT_NE(wp, nullptr);
+}
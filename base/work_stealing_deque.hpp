@@ -0,0 +1,151 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "base/epoch.hpp"
+#include "base/macro.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace base {
+
+// Chase-Lev work-stealing deque (with the memory orders from "Correct and Efficient
+// Work-Stealing for Weak Memory Models", Lê et al.). The single owner thread pushes
+// and takes at the bottom, in LIFO order, while any number of thieves steal from the
+// top, in FIFO order. Grows on demand; only the owner may grow it.
+template <class T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Items are read and written atomically, use pointers or handles");
+
+ public:
+  explicit WorkStealingDeque(std::size_t capacity = 256) /* may throw */
+      : array_(new Array(round_up(capacity))) {}
+
+  ~WorkStealingDeque() noexcept { delete array_.load(std::memory_order_relaxed); }
+
+  DISABLE_COPY_MOVE(WorkStealingDeque);
+
+  // Owner only.
+  void push(T item) /* may throw */ {
+    const auto bottom = bottom_.load(std::memory_order_relaxed);
+    const auto top = top_.load(std::memory_order_acquire);
+    auto* array = array_.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<std::int64_t>(array->mask)) {
+      array = grow(array, top, bottom);
+    }
+    array->put(bottom, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  // Owner only. Takes the most recently pushed item.
+  std::optional<T> take() noexcept {
+    const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    auto* array = array_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      // Empty.
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return {};
+    }
+    std::optional<T> item = array->get(bottom);
+    if (top == bottom) {
+      // The last item, race the thieves for it.
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        item.reset();
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // Any thread. Takes the least recently pushed item. May spuriously return nothing,
+  // if lost a race with another thief or the owner.
+  std::optional<T> steal() noexcept {
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+      return {};
+
+    // Keeps the array from being freed, if the owner grows the deque meanwhile.
+    EpochGuard guard;
+    auto* array = array_.load(std::memory_order_acquire);
+    const T item = array->get(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return {};
+    }
+    return item;
+  }
+
+  // Exact only if the deque is not being modified.
+  GETTER bool empty() const noexcept {
+    return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr std::size_t kCacheLineSize = 64;
+
+  struct Array {
+    explicit Array(std::size_t capacity)
+        : mask(capacity - 1), items(new std::atomic<T>[capacity]) {}
+
+    T get(std::int64_t index) const noexcept {
+      return items[index & mask].load(std::memory_order_relaxed);
+    }
+    void put(std::int64_t index, T item) noexcept {
+      items[index & mask].store(item, std::memory_order_relaxed);
+    }
+
+    const std::size_t mask;
+    const std::unique_ptr<std::atomic<T>[]> items;
+  };
+
+  static std::size_t round_up(std::size_t capacity) noexcept {
+    std::size_t result = 2;
+    while (result < capacity)
+      result *= 2;
+    return result;
+  }
+
+  Array* grow(Array* array, std::int64_t top, std::int64_t bottom) /* may throw */ {
+    auto* grown = new Array((array->mask + 1) * 2);
+    for (auto index = top; index < bottom; ++index) {
+      grown->put(index, array->get(index));
+    }
+    array_.store(grown, std::memory_order_release);
+    // Thieves may still read the old array.
+    epoch_retire(array);
+    return grown;
+  }
+
+  alignas(kCacheLineSize) std::atomic<std::int64_t> top_{0};
+  alignas(kCacheLineSize) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<Array*> array_;
+};
+
+}  // namespace base
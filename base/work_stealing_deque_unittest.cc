@@ -0,0 +1,84 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/work_stealing_deque.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(WorkStealingDequeTest, OwnerTakesLastThiefStealsFirst) {
+  base::WorkStealingDeque<int> deque{2};
+  EXPECT_FALSE(deque.take());
+  EXPECT_FALSE(deque.steal());
+
+  // Grows past the initial capacity.
+  for (int i = 0; i < 10; ++i) {
+    deque.push(i);
+  }
+  EXPECT_EQ(deque.take(), 9);
+  EXPECT_EQ(deque.steal(), 0);
+  EXPECT_EQ(deque.steal(), 1);
+  EXPECT_EQ(deque.take(), 8);
+  for (int i = 2; i < 8; ++i) {
+    EXPECT_EQ(deque.steal(), i);
+  }
+  EXPECT_FALSE(deque.take());
+  EXPECT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDequeTest, EachItemIsTakenOnce) {
+  constexpr int kItems = 100000;
+  constexpr int kThieves = 4;
+  base::WorkStealingDeque<int> deque{16};
+  std::vector<std::atomic<int>> taken(kItems);
+  std::atomic<int> total = 0;
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kThieves; ++i) {
+    thieves.emplace_back([&]() {
+      while (total.load() < kItems) {
+        if (auto item = deque.steal()) {
+          taken[*item].fetch_add(1);
+          total.fetch_add(1);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < kItems; ++i) {
+    deque.push(i);
+    if (i % 3 == 0) {
+      if (auto item = deque.take()) {
+        taken[*item].fetch_add(1);
+        total.fetch_add(1);
+      }
+    }
+  }
+  while (auto item = deque.take()) {
+    taken[*item].fetch_add(1);
+    total.fetch_add(1);
+  }
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+
+  EXPECT_EQ(total.load(), kItems);
+  for (int i = 0; i < kItems; ++i) {
+    ASSERT_EQ(taken[i].load(), 1) << "item " << i;
+  }
+}
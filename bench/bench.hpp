@@ -0,0 +1,70 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Plain `std::chrono` loops, printing a line per measurement. Suites are registered
+// with `BENCH_SUITE(name)` and run all, or only those named on the command line.
+#define BENCH_SUITE(name)                                                   \
+  static void bench_suite_##name();                                         \
+  static const ::bench::Registrar bench_registrar_##name{#name,             \
+                                                         &bench_suite_##name}; \
+  static void bench_suite_##name()
+
+namespace bench {
+
+using clock_t = std::chrono::steady_clock;
+
+struct Registrar {
+  Registrar(const char* name, void (*suite)()) noexcept;
+};
+
+// CPU time, consumed by all the threads of the process.
+std::chrono::nanoseconds cpu_time() noexcept;
+
+void report(std::string_view name, double value, std::string_view unit);
+
+// Keeps the compiler from optimizing the `value` away.
+template <class T>
+inline void keep(const T& value) noexcept {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs the `body` and returns the wall time per each of its `ops` operations.
+template <class F>
+double ns_per_op(std::size_t ops, F&& body) {
+  const auto start = clock_t::now();
+  body();
+  const std::chrono::duration<double, std::nano> elapsed = clock_t::now() - start;
+  return elapsed.count() / static_cast<double>(ops);
+}
+
+// Sorts the `samples` in place.
+template <class T>
+T percentile(std::vector<T>& samples, double percent) {
+  std::sort(samples.begin(), samples.end());
+  const auto index = static_cast<std::size_t>(percent / 100.0 *
+                                              static_cast<double>(samples.size() - 1));
+  return samples[index];
+}
+
+}  // namespace bench
@@ -0,0 +1,100 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench.hpp"
+
+#include "base/epoch.hpp"
+#include "base/work_stealing_deque.hpp"
+
+#include <malloc.h>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+constexpr int kOps = 4'000'000;
+
+// Large arrays are mmapped, so those are counted too.
+double allocated_bytes() noexcept {
+  const auto info = ::mallinfo2();
+  return static_cast<double>(info.uordblks + info.hblkhd);
+}
+
+struct Retired {
+  std::int64_t payload[4];
+};
+
+}  // namespace
+
+BENCH_SUITE(epoch) {
+  bench::report("EpochGuard pin and unpin", bench::ns_per_op(kOps, []() {
+                  for (int i = 0; i < kOps; ++i) {
+                    base::EpochGuard guard;
+                    bench::keep(guard);
+                  }
+                }),
+                "ns/op");
+
+  bench::report("epoch_retire and reclaim", bench::ns_per_op(kOps / 4, []() {
+                  for (int i = 0; i < kOps / 4; ++i)
+                    base::epoch_retire(new Retired{});
+                  base::epoch_reclaim();
+                  base::epoch_reclaim();
+                }),
+                "ns/object");
+}
+
+BENCH_SUITE(work_stealing_deque) {
+  {
+    base::WorkStealingDeque<std::intptr_t> deque;
+    bench::report("push and take, owner", bench::ns_per_op(kOps, [&deque]() {
+                    for (int i = 0; i < kOps; ++i) {
+                      deque.push(i);
+                      bench::keep(deque.take());
+                    }
+                  }),
+                  "ns/op");
+  }
+
+  {
+    base::WorkStealingDeque<std::intptr_t> deque{kOps};
+    for (int i = 0; i < kOps; ++i)
+      deque.push(i);
+    double ns = 0;
+    std::thread([&]() {
+      ns = bench::ns_per_op(kOps, [&deque]() {
+        for (int i = 0; i < kOps; ++i)
+          bench::keep(deque.steal());
+      });
+    }).join();
+    bench::report("steal, uncontended", ns, "ns/op");
+  }
+
+  {
+    // Grows from the smallest array to 1M items, then the old arrays are reclaimed.
+    const auto before = allocated_bytes();
+    base::WorkStealingDeque<std::intptr_t> deque{2};
+    constexpr int kItems = 1 << 20;
+    for (int i = 0; i < kItems; ++i)
+      deque.push(i);
+    while (deque.take()) {
+    }
+    base::epoch_reclaim();
+    base::epoch_reclaim();
+    const double live_array = kItems * sizeof(std::intptr_t);
+    bench::report("retained besides the live array, 1M items",
+                  (allocated_bytes() - before - live_array) / 1024, "KiB");
+  }
+}
@@ -0,0 +1,60 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench.hpp"
+
+#include <time.h>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace bench {
+
+namespace {
+std::vector<std::pair<const char*, void (*)()>>& suites() {
+  static std::vector<std::pair<const char*, void (*)()>> suites;
+  return suites;
+}
+}  // namespace
+
+Registrar::Registrar(const char* name, void (*suite)()) noexcept {
+  suites().emplace_back(name, suite);
+}
+
+std::chrono::nanoseconds cpu_time() noexcept {
+  timespec time;
+  ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+}
+
+void report(std::string_view name, double value, std::string_view unit) {
+  std::printf("%-48.*s %12.1f %.*s\n", static_cast<int>(name.size()), name.data(), value,
+              static_cast<int>(unit.size()), unit.data());
+  std::fflush(stdout);
+}
+
+}  // namespace bench
+
+int main(int argc, char** argv) {
+  for (const auto& [name, suite] : bench::suites()) {
+    bool selected = argc == 1;
+    for (int i = 1; i < argc; ++i)
+      selected = selected || std::string_view(argv[i]) == name;
+    if (!selected)
+      continue;
+    std::printf("== %s\n", name);
+    suite();
+  }
+}
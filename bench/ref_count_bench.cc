@@ -0,0 +1,71 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench.hpp"
+
+#include "base/ref_ptr.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr int kCopies = 10'000'000;
+
+struct Plain : public base::RefCounted {
+  int value = 0;
+};
+struct ThreadSafe : public base::RefCountedThreadSafe {
+  int value = 0;
+};
+struct Biased : public base::RefCountedBiased {
+  int value = 0;
+};
+
+// Copies and drops the pointer over and over, as passing it around by value does.
+template <class Ptr>
+double copy_ns(const Ptr& ptr) {
+  return bench::ns_per_op(kCopies, [&ptr]() {
+    for (int i = 0; i < kCopies; ++i) {
+      Ptr copy = ptr;
+      bench::keep(copy);
+    }
+  });
+}
+
+template <class T>
+void report_ref_ptr(const std::string& name) {
+  auto ptr = base::make_ref_ptr<T>();
+  bench::report(name + ", owner thread", copy_ns(ptr), "ns/copy");
+  double other_thread = 0;
+  std::thread([&]() { other_thread = copy_ns(ptr); }).join();
+  bench::report(name + ", other thread", other_thread, "ns/copy");
+}
+
+}  // namespace
+
+BENCH_SUITE(ref_count) {
+  report_ref_ptr<Plain>("ref_ptr<RefCounted>");
+  report_ref_ptr<ThreadSafe>("ref_ptr<RefCountedThreadSafe>");
+  report_ref_ptr<Biased>("ref_ptr<RefCountedBiased>");
+  base::merge_biased_ref_counts();
+
+  auto shared = std::make_shared<int>(0);
+  bench::report("std::shared_ptr, owner thread", copy_ns(shared), "ns/copy");
+  double other_thread = 0;
+  std::thread([&]() { other_thread = copy_ns(shared); }).join();
+  bench::report("std::shared_ptr, other thread", other_thread, "ns/copy");
+}
@@ -0,0 +1,120 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench.hpp"
+
+#include "base/run_loop.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Runs a loop on its own thread for the scope.
+class LoopThread {
+ public:
+  LoopThread() {
+    thread_ = std::thread([this]() {
+      base::RunLoop loop;
+      loop_.store(&loop, std::memory_order_release);
+      loop.run();
+      loop_.store(nullptr, std::memory_order_release);
+    });
+    while (!loop_.load(std::memory_order_acquire))
+      std::this_thread::yield();
+  }
+
+  ~LoopThread() {
+    loop().post([this]() { loop().exit_when_idle(); });
+    thread_.join();
+  }
+
+  base::RunLoop& loop() noexcept { return *loop_.load(std::memory_order_acquire); }
+
+ private:
+  std::atomic<base::RunLoop*> loop_{nullptr};
+  std::thread thread_;
+};
+
+}  // namespace
+
+BENCH_SUITE(run_loop_latency) {
+  constexpr int kPosts = 2000;
+  LoopThread loop_thread;
+  std::vector<std::int64_t> latencies;
+  latencies.reserve(kPosts);
+
+  for (int i = 0; i < kPosts; ++i) {
+    // Lets the loop run out of work and go to sleep.
+    std::this_thread::sleep_for(100us);
+    std::atomic<bool> done{false};
+    const auto posted = bench::clock_t::now();
+    loop_thread.loop().post([&]() {
+      latencies.push_back((bench::clock_t::now() - posted).count());
+      done.store(true, std::memory_order_release);
+    });
+    while (!done.load(std::memory_order_acquire))
+      std::this_thread::yield();
+  }
+
+  bench::report("post to run, idle loop, p50", bench::percentile(latencies, 50) / 1e3,
+                "us");
+  bench::report("post to run, idle loop, p99", bench::percentile(latencies, 99) / 1e3,
+                "us");
+}
+
+BENCH_SUITE(run_loop_idle_cpu) {
+  LoopThread loop_thread;
+  std::this_thread::sleep_for(50ms);
+
+  const auto cpu_before = bench::cpu_time();
+  const auto wall_before = bench::clock_t::now();
+  std::this_thread::sleep_for(500ms);
+  const std::chrono::duration<double> cpu = bench::cpu_time() - cpu_before;
+  const std::chrono::duration<double> wall = bench::clock_t::now() - wall_before;
+
+  bench::report("idle loop CPU usage", cpu / wall * 100.0, "% of a core");
+}
+
+BENCH_SUITE(run_loop_producers) {
+  constexpr int kTotalPosts = 400000;
+  for (int producers : {1, 4, 16}) {
+    LoopThread loop_thread;
+    auto& loop = loop_thread.loop();
+    std::atomic<int> left{kTotalPosts};
+    const auto ns = bench::ns_per_op(kTotalPosts, [&]() {
+      std::vector<std::thread> threads;
+      for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&]() {
+          for (int i = 0; i < kTotalPosts / producers; ++i) {
+            loop.post([&left]() {
+              if (left.fetch_sub(1, std::memory_order_relaxed) == 1)
+                left.notify_one();
+            });
+          }
+        });
+      }
+      for (auto& thread : threads)
+        thread.join();
+      for (auto value = left.load(); value != 0; value = left.load())
+        left.wait(value);
+    });
+    bench::report(std::to_string(producers) + " producers, throughput", 1e3 / ns,
+                  "M tasks/s");
+  }
+}
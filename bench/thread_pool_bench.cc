@@ -0,0 +1,78 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench.hpp"
+
+#include "base/thread_pool.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace {
+
+// Posts `tasks` tasks, each of which spawns `subtasks` more from its worker, and
+// returns the wall time per task, once they all have run.
+double run_tasks(std::size_t workers, int tasks, int subtasks, int work) {
+  base::ThreadPool pool{workers};
+  std::atomic<int> left{tasks * (1 + subtasks)};
+
+  const auto task = [&left, work]() {
+    double x = 1.0;
+    for (int i = 0; i < work; ++i)
+      x = std::sqrt(x + i);
+    bench::keep(x);
+    if (left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      left.notify_one();
+  };
+  return bench::ns_per_op(tasks * (1 + subtasks), [&]() {
+    for (int i = 0; i < tasks; ++i) {
+      pool.post([&pool, &task, subtasks]() {
+        for (int j = 0; j < subtasks; ++j)
+          pool.post(task);
+        task();
+      });
+    }
+    for (auto value = left.load(); value != 0; value = left.load())
+      left.wait(value);
+  });
+}
+
+}  // namespace
+
+BENCH_SUITE(thread_pool_scaling) {
+  const auto cores = std::max(1u, std::thread::hardware_concurrency());
+  std::printf("(%u hardware threads)\n", cores);
+
+  double single = 0;
+  for (std::size_t workers = 1; workers <= std::max(8u, cores); workers *= 2) {
+    // A few tens of microseconds of work per task.
+    const auto ns = run_tasks(workers, 256, 7, 4000);
+    if (workers == 1)
+      single = ns;
+    const auto prefix = std::to_string(workers) + " workers, ";
+    bench::report(prefix + "busy tasks", ns / 1e3, "us/task");
+    bench::report(prefix + "speedup", single / ns, "x");
+  }
+}
+
+BENCH_SUITE(thread_pool_overhead) {
+  for (std::size_t workers : {1u, 4u}) {
+    const auto ns = run_tasks(workers, 20000, 7, 0);
+    bench::report(std::to_string(workers) + " workers, empty tasks", ns, "ns/task");
+  }
+}
@@ -0,0 +1,96 @@
+/* Copyright 2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench/bench.hpp"
+
+#include "base/object_pool.hpp"
+#include "cursedui/view.hpp"
+#include "cursedui/views/linear_layout.hpp"
+#include "cursedui/views/text_view.hpp"
+
+#include <malloc.h>
+#include <string>
+
+namespace {
+
+using namespace cursedui::view;
+
+constexpr int kGroups = 1000;
+constexpr int kViewsPerGroup = 49;
+constexpr int kViews = kGroups * (kViewsPerGroup + 1) + 1;
+constexpr int kTraversals = 200;
+
+double allocated_bytes() noexcept {
+  const auto info = ::mallinfo2();
+  return static_cast<double>(info.uordblks + info.hblkhd);
+}
+
+// Touches each view, like the layout and drawing passes do.
+class BoundsVisitor final : public ViewTreeVisitor {
+ public:
+  VisitResult visit(View* view) const override {
+    bench::keep(view->outer_bounds());
+    return VisitResult::CONTINUE_VISIT;
+  }
+};
+
+// Like the views of a real tree, each text view allocates its text and its layout
+// params along with itself.
+base::ref_ptr<View> build_tree(base::ObjectPool* pool) {
+  auto root = base::make_ref_ptr_in<LinearLayout>(pool);
+  for (int i = 0; i < kGroups; ++i) {
+    auto group = base::make_ref_ptr_in<LinearLayout>(pool);
+    for (int j = 0; j < kViewsPerGroup; ++j) {
+      auto text = base::make_ref_ptr_in<TextView>(pool);
+      text->set_text("A label, which does not fit SSO " + std::to_string(j));
+      group->add_child(std::move(text));
+    }
+    root->add_child(std::move(group));
+  }
+  return root;
+}
+
+void bench_tree(std::string_view label, bool pooled) {
+  const auto before = allocated_bytes();
+  auto pool = pooled ? base::make_ref_ptr<base::ObjectPool>() : nullptr;
+  base::ref_ptr<View> root;
+  bench::report(std::string(label) + ", build",
+                bench::ns_per_op(kViews, [&]() { root = build_tree(pool.get()); }),
+                "ns/view");
+  bench::report(std::string(label) + ", memory",
+                (allocated_bytes() - before) / kViews, "bytes/view");
+
+  root->layout_as_root({0, 0, 200, 60});
+  std::vector<double> samples;
+  const BoundsVisitor visitor;
+  for (int i = 0; i < kTraversals; ++i)
+    samples.push_back(bench::ns_per_op(kViews, [&]() { root->visit_down(visitor); }));
+  bench::report(std::string(label) + ", visit_down p50",
+                bench::percentile(samples, 50), "ns/view");
+
+  bench::report(std::string(label) + ", destroy",
+                bench::ns_per_op(kViews, [&]() { root = nullptr; }), "ns/view");
+}
+
+}  // namespace
+
+// A tree of 50k views, allocated one by one from the heap, or from one pool.
+BENCH_SUITE(view_tree) {
+  // The trees are built after another one is gone, like when a screen is rebuilt. This
+  // also keeps growing the heap from being charged to whichever tree goes first.
+  bench::keep(build_tree(nullptr));
+  bench_tree("heap", /*pooled=*/false);
+  bench_tree("pool", /*pooled=*/true);
+}
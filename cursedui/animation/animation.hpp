@@ -15,8 +15,9 @@
 
 #pragma once
 
+#include "base/handle.hpp"
 #include "base/macro.hpp"
-#include "base/weak_ref.hpp"
+#include "base/ref_ptr.hpp"
 
 #include "cursedui/config.hpp"
 
@@ -25,7 +26,7 @@
 namespace cursedui::animation {
 using namespace std::chrono_literals;
 
-class CURSEDUI_PUBLIC Animation : public base::WeakReferenced {
+class CURSEDUI_PUBLIC Animation : public base::RefCounted, public base::Handled {
  public:
   using clock_t = std::chrono::steady_clock;
   using duration_t = clock_t::duration;
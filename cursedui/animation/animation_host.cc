@@ -28,12 +28,14 @@ void AnimationHost::tick() {
   if (delta >= Animation::interval_v) {
     last_tick_ = now;
     for (auto& animation : animations_) {
-      if (auto anim = animation.lock()) {
+      if (auto* anim = animation.get()) {
+        // The frame may release the animation.
+        base::ref_ptr<Animation> keep_alive(anim);
         anim->on_frame();
       }
     }
-    animations_.remove_if([](auto animation) {
-      auto anim = animation.lock();
+    animations_.remove_if([](const auto& animation) {
+      auto* anim = animation.get();
       return !anim || anim->is_finished();
     });
   }
@@ -45,7 +47,7 @@ void AnimationHost::start(Animation* animation) {
   if (animation->is_finished())
     return;
 
-  animations_.emplace_back(animation);
+  animations_.emplace_back(base::Handle(animation));
 }
 
 }  // namespace cursedui::animation
@@ -15,8 +15,8 @@
 
 #pragma once
 
+#include "base/handle.hpp"
 #include "base/macro.hpp"
-#include "base/weak_ref.hpp"
 #include "cursedui/animation/animation.hpp"
 
 #include "cursedui/config.hpp"
@@ -40,13 +40,15 @@ class CURSEDUI_PUBLIC AnimationHost {
 
   void start(Animation* animation);
 
+  GETTER bool running() const noexcept { return !animations_.empty(); }
+
  private:
   friend class cursedui::ViewTreeHost;
 
   void tick();
 
   Animation::time_point_t last_tick_;
-  std::list<base::weak_ref<Animation>> animations_;
+  std::list<base::Handle<Animation>> animations_;
 };
 
 }  // namespace cursedui::animation
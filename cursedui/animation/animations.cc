@@ -90,7 +90,7 @@ void ValueAnimation<T>::on_frame() {
 
   const auto passed = clock_t::now() - start_time_.value();
   const auto progress = static_cast<double>(passed.count()) / duration_.count();
-  LOG() << "progress " << progress;
+  LOG(GENERAL, VERBOSE) << "progress " << progress;
   if (progress > 1.0) {
     value_.set(to_);
     finished_ = true;
@@ -38,10 +38,15 @@ inline avada::render::Color blend(avada::render::Color src,
   return src;
 }
 
+template <class Char>
+bool overwrites_data(Char data, const Pen& pen) {
+  return pen.fg_blend_mode != BlendMode::BLEND || !is_blank_char(data) ||
+         std::holds_alternative<avada::render::SystemColor>(pen.bg_color);
+}
+
 template <class Char>
 void paint_cell(avada::render::Buffer::Cell& cell, Char data, const Pen& pen) {
-  if (pen.fg_blend_mode == BlendMode::BLEND && is_blank_char(data) && 
-      !std::holds_alternative<avada::render::SystemColor>(pen.bg_color)) {
+  if (!overwrites_data(data, pen)) {
     // if blend mode is on and data is blank: no data overwriting and we blend fg with bg
     // NOTE: thus, fg color is ignored (is this right?)
     auto color = blend(pen.bg_color, cell.fg_color(), pen.fg_blend_mode);
@@ -60,25 +65,77 @@ void paint_cell(avada::render::Buffer::Cell& cell, Char data, const Pen& pen) {
                           : pen.render_attributes);
 }
 
+// Paints a glyph at (i, j) of a row clipped at `right` (inclusive). A wide glyph takes
+// two cells, the second one becomes its continuation. If the second half of the glyph is
+// clipped out, a blank is painted instead. Returns the number of cells taken.
+template <class Char>
+int paint_glyph(avada::render::Buffer& buffer,
+                int i,
+                int j,
+                int right,
+                Char data,
+                const Pen& pen) {
+  auto width = avada::render::glyph_width(data);
+  if (UNLIKELY(width == 2 && j + 1 > std::min(right, buffer.columns() - 1))) {
+    data = ' ';
+    width = 1;
+  }
+
+  if (overwrites_data(data, pen)) {
+    // Don't leave halves of the overwritten wide glyphs behind.
+    buffer.split_glyph(i, j);
+    if (width == 2)
+      buffer.split_glyph(i, j + 1);
+  }
+
+  auto& cell = buffer(i, j);
+  paint_cell(cell, data, pen);
+  if (width == 2) {
+    auto& continuation = buffer(i, j + 1);
+    continuation.set_continuation();
+    continuation.set_fg_color(cell.fg_color());
+    continuation.set_bg_color(cell.bg_color());
+    continuation.set_attributes(cell.attributes());
+  }
+  return width;
+}
+
 }  // namespace
 
-Canvas::Canvas(avada::render::Buffer& buffer) noexcept : buffer_(buffer) {}
+Canvas::Canvas(avada::render::Buffer& buffer,
+               std::pmr::memory_resource* resource) noexcept
+    : resource_(resource),
+      clip_stack_(std::pmr::vector<paint::Region>(resource)),
+      buffer_(buffer) {}
 
 template <typename Char>
 void Canvas::draw(std::basic_string_view<Char> str,
                   gfx::Point start,
                   const Pen& pen) noexcept {
-  auto rect = gfx::rect_from(start, {static_cast<gfx::dim_t>(str.size()), 1});
+  gfx::dim_t width = 0;
+  for (auto c : str)
+    width += avada::render::glyph_width(c);
+
+  auto rect = gfx::rect_from(start, {width, 1});
   auto clipped = apply_clip(rect);
   if (clipped.empty())
     return;
 
   for (auto& clipped_rect : clipped) {
-    auto clipped_str = str;
-    clipped_str.remove_prefix(clipped_rect.left - rect.left);
-    auto str_iter = std::begin(clipped_str);
-    for (auto j = clipped_rect.left; j <= clipped_rect.right; ++j)
-      paint_cell(buffer_(clipped_rect.top, j), *str_iter++, pen);
+    auto j = rect.left;
+    for (auto c : str) {
+      if (j > clipped_rect.right)
+        break;
+      const auto glyph_width = avada::render::glyph_width(c);
+      if (j >= clipped_rect.left) {
+        paint_glyph(buffer_, clipped_rect.top, j, clipped_rect.right, c, pen);
+      } else if (j + glyph_width > clipped_rect.left) {
+        // The left half of a wide glyph is clipped out, blank the right one.
+        paint_glyph(buffer_, clipped_rect.top, clipped_rect.left, clipped_rect.right,
+                    Char(' '), pen);
+      }
+      j += glyph_width;
+    }
   }
 }
 
@@ -90,7 +147,12 @@ void Canvas::draw(Char c, gfx::Point position, const Pen& pen) noexcept {
     return;
   if (!clip_stack_.empty() && !clip_stack_.top().clip(position))
     return;
-  paint_cell(buffer_(position.y, position.x), c, pen);
+
+  // Wide glyph needs the next cell to be visible as well.
+  const gfx::Point next{position.x + 1, position.y};
+  const auto right = clip_stack_.empty() || clip_stack_.top().clip(next) ? next.x
+                                                                          : position.x;
+  paint_glyph(buffer_, position.y, position.x, right, c, pen);
 }
 
 template <typename Char>
@@ -99,20 +161,25 @@ void Canvas::draw_line(Char c,
                        Direction direction,
                        gfx::dim_t count,
                        const Pen& pen) noexcept {
-  auto rect = direction == Direction::HORIZONTAL ? gfx::rect_from(start, {count, 1})
-                                                 : gfx::rect_from(start, {1, count});
+  const auto glyph_width = avada::render::glyph_width(c);
+  auto rect = direction == Direction::HORIZONTAL
+                  ? gfx::rect_from(start, {count, 1})
+                  : gfx::rect_from(start, {glyph_width, count});
   auto clipped = apply_clip(rect);
   if (clipped.empty())
     return;
 
   if (direction == Direction::HORIZONTAL)
     for (auto& region_part : clipped)
-      for (auto j = region_part.left; j <= region_part.right; ++j)
-        paint_cell(buffer_(region_part.top, j), c, pen);
+      for (auto j = region_part.left; j <= region_part.right;)
+        j += paint_glyph(buffer_, region_part.top, j, region_part.right, c, pen);
   else
     for (auto& region_part : clipped)
       for (auto i = region_part.top; i <= region_part.bottom; ++i)
-        paint_cell(buffer_(i, region_part.left), c, pen);
+        if (region_part.left == start.x)
+          paint_glyph(buffer_, i, region_part.left, region_part.right, c, pen);
+        else  // The left half of a wide glyph is clipped out.
+          paint_glyph(buffer_, i, region_part.left, region_part.right, Char(' '), pen);
 }
 
 template <typename Char>
@@ -123,8 +190,8 @@ void Canvas::fill(Char c, gfx::Rect rect, const Pen& pen) noexcept {
 
   for (auto& region_part : clipped)
     for (auto i = region_part.top; i <= region_part.bottom; ++i)
-      for (auto j = region_part.left; j <= region_part.right; ++j)
-        paint_cell(buffer_(i, j), c, pen);
+      for (auto j = region_part.left; j <= region_part.right;)
+        j += paint_glyph(buffer_, i, j, region_part.right, c, pen);
 }
 
 void Canvas::draw(const avada::render::Buffer& buffer,
@@ -158,12 +225,13 @@ void Canvas::draw(const avada::render::Buffer& buffer,
 
 Canvas::ScopedClipHandle Canvas::push_clip(const gfx::Rect& rect) noexcept {
   if (UNLIKELY(clip_stack_.empty())) {
-    clip_stack_.emplace(rect);
+    clip_stack_.emplace(rect, resource_);
     return {*this, !rect.has_area()};
   }
   auto new_clip = clip_stack_.top().clip(rect);
-  clip_stack_.push(new_clip);
-  return {*this, new_clip.empty()};
+  const bool culled = new_clip.empty();
+  clip_stack_.push(std::move(new_clip));
+  return {*this, culled};
 }
 
 Canvas::ScopedClipHandle Canvas::push_clip(const Region& region) noexcept {
@@ -172,8 +240,9 @@ Canvas::ScopedClipHandle Canvas::push_clip(const Region& region) noexcept {
     return {*this, region.empty()};
   }
   auto new_clip = clip_stack_.top().clip(region);
-  clip_stack_.push(new_clip);
-  return {*this, new_clip.empty()};
+  const bool culled = new_clip.empty();
+  clip_stack_.push(std::move(new_clip));
+  return {*this, culled};
 }
 
 void Canvas::pop_clip() noexcept {
@@ -184,7 +253,7 @@ paint::Region Canvas::apply_clip(const gfx::Rect& rect) const noexcept {
   auto clipped = clip_to_buffer(rect);
 
   if (UNLIKELY(clip_stack_.empty())) {
-    return paint::Region{clipped};
+    return paint::Region{clipped, resource_};
   }
 
   return clip_stack_.top().clip(clipped);
@@ -22,9 +22,11 @@
 #include "cursedui/config.hpp"
 
 #include <array>
+#include <memory_resource>
 #include <stack>
 #include <string_view>
 #include <variant>
+#include <vector>
 
 namespace avada::render {
 class Buffer;
@@ -62,7 +64,10 @@ enum class CURSEDUI_PUBLIC Direction : uint8_t { HORIZONTAL, VERTICAL };
 
 class CURSEDUI_PUBLIC Canvas {
  public:
-  explicit Canvas(avada::render::Buffer& buffer) noexcept;
+  // The clip regions are allocated from `resource`.
+  explicit Canvas(
+      avada::render::Buffer& buffer,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
 
   class ScopedClipHandle {
    public:
@@ -80,7 +85,8 @@ class CURSEDUI_PUBLIC Canvas {
     const bool culled_;
   };
 
-  // Basic painting API:
+  // Basic painting API. Wide glyphs take two cells, and are replaced with blanks if
+  // clipped in half. `count` of `draw_line` is in cells.
   template <typename Char>
   void draw(std::basic_string_view<Char> str, gfx::Point start, const Pen& pen) noexcept;
 
@@ -118,7 +124,8 @@ class CURSEDUI_PUBLIC Canvas {
   gfx::Rect clip_to_buffer(const gfx::Rect& rect) const noexcept;
 
  private:
-  std::stack<paint::Region> clip_stack_;
+  std::pmr::memory_resource* const resource_;
+  std::stack<paint::Region, std::pmr::vector<paint::Region>> clip_stack_;
   avada::render::Buffer& buffer_;
 };
 
@@ -13,8 +13,13 @@
  * limitations under the License.
  */
 
+#include "avada/avada.hpp"
 #include "avada/color.hpp"
+#include "base/debug/async_logger.hpp"
 #include "base/debug/debug.hpp"
+#include "base/debug/tracing.hpp"
+#include "base/env_utils.hpp"
+#include "base/object_pool.hpp"
 #include "base/run_loop.hpp"
 #include "cursedui/drawable.hpp"
 #include "cursedui/view_tree_host.hpp"
@@ -27,32 +32,58 @@
 #include <iterator>
 #include <locale>
 #include <memory>
+#include <optional>
+#include <sstream>
 
 int main() {
   using namespace cursedui;
   using namespace base::operators;
 
+  // Before the logger and the tracer start their threads.
+  avada::block_resize_signal();
+
   std::setlocale(LC_ALL, "");
 
-  base::debug::LoggerToStdErr logger;
-  base::debug::setup_logging(&logger);
+  // The terminal is taken by the UI, so log into a file, if asked.
+  base::debug::LoggerToStdErr stderr_logger;
+  std::optional<base::debug::AsyncLogger> file_logger;
+  if (const auto log_file = base::get_env("CURSEDUI_LOG_FILE")) {
+    file_logger.emplace(*log_file);
+    base::debug::setup_logging(&*file_logger);
+  } else {
+    base::debug::setup_logging(&stderr_logger);
+  }
+  // E.g. "render,input", the rest of the categories is skipped before formatting.
+  if (const auto categories = base::get_env("CURSEDUI_LOG_CATEGORIES")) {
+    if (!base::debug::enable_only_log_categories(*categories))
+      LOG(GENERAL, WARNING) << "Unknown log category in '" << *categories << "'";
+  }
 
   base::RunLoop main_loop;
   base::RunLoop::set_main(&main_loop);
+  const bool dump_loop_stats = base::get_env("CURSEDUI_LOOP_STATS").has_value();
+  main_loop.set_instrumentation_enabled(dump_loop_stats);
+  // Open the file in Perfetto or chrome://tracing.
+  std::optional<base::debug::TraceRecorder> trace_recorder;
+  if (const auto trace_file = base::get_env("CURSEDUI_TRACE_FILE")) {
+    trace_recorder.emplace(*trace_file);
+  }
 
-  auto root = base::make_ref_ptr<view::FrameLayout>();
+  // The whole tree is allocated together.
+  auto view_pool = base::make_ref_ptr<base::ObjectPool>();
+  auto root = base::make_ref_ptr_in<view::FrameLayout>(view_pool.get());
   root->set_debug_name("root-frame");
 
-  auto scroll_view = base::make_ref_ptr<view::ScrollView>();
+  auto scroll_view = base::make_ref_ptr_in<view::ScrollView>(view_pool.get());
   scroll_view->border().set_style(BorderDrawable::Style::SINGLE);
 
-  auto lin_layout = base::make_ref_ptr<view::LinearLayout>();
+  auto lin_layout = base::make_ref_ptr_in<view::LinearLayout>(view_pool.get());
   lin_layout->set_debug_name("root-hor-linear-layout");
   lin_layout->set_layout_params(std::make_unique<view::LayoutParams>(
       view::LayoutMatchParent{}, view::LayoutMatchParent{}));
   root->add_child(lin_layout);
 
-  auto overlay = base::make_ref_ptr<view::TextView>();
+  auto overlay = base::make_ref_ptr_in<view::TextView>(view_pool.get());
   overlay->set_layout_params(std::make_unique<view::LayoutParams>(
       view::LayoutWrapContent{}, view::LayoutMatchParent{}));
   overlay->set_text("Hello world!");
@@ -61,12 +92,12 @@ int main() {
   root->add_child(overlay);
 
   lin_layout->set_background_color(avada::render::ColorRGB{33, 20, 20});
-  auto lin_layout2 = base::make_ref_ptr<view::LinearLayout>();
+  auto lin_layout2 = base::make_ref_ptr_in<view::LinearLayout>(view_pool.get());
   lin_layout2->set_orientation(view::LinearLayout::VERTICAL);
   lin_layout2->set_debug_name("child-ver-linear-layout");
 
-  auto view1 = base::make_ref_ptr<view::TextView>();
-  auto view2 = base::make_ref_ptr<view::TextView>();
+  auto view1 = base::make_ref_ptr_in<view::TextView>(view_pool.get());
+  auto view2 = base::make_ref_ptr_in<view::TextView>(view_pool.get());
   view1->set_gravity(gfx::Gravity::TOP | gfx::Gravity::LEFT);
   view1->set_debug_name("text-view-A");
   std::ifstream ifs{"/home/jeffset/text.txt"};
@@ -75,6 +106,7 @@ int main() {
   LOG() << "SOURCE TEXT: " << string << '\n';
   // view1->set_text(wstring + wstring);
   view1->set_multiline(true);
+  view1->set_editable(true);
   view1->border().set_style(BorderDrawable::Style::NO_BORDER);
 
   view1->set_background_color(avada::render::ColorRGB{100, 34, 40});
@@ -101,9 +133,9 @@ int main() {
   lp2->set_weight(0.5f);
   lp2->set_height_layout_spec(view::LayoutMatchParent{});
 
-  auto view3 = base::make_ref_ptr<view::TextView>();
+  auto view3 = base::make_ref_ptr_in<view::TextView>(view_pool.get());
   view3->border().set_color(avada::render::ColorRGB{0, 255, 200});
-  auto view4 = base::make_ref_ptr<view::TextView>();
+  auto view4 = base::make_ref_ptr_in<view::TextView>(view_pool.get());
   view4->border().set_color(avada::render::ColorRGB{0, 50, 18});
   view4->border().set_background_color(avada::render::ColorRGB{128, 255, 255});
   view3->set_text("Test ◕ string");
@@ -126,11 +158,15 @@ int main() {
   ll->set_weight(0.5f);
 
   try {
-    ViewTreeHost view_tree_host{root};
-    main_loop.run([&view_tree_host]() {
-      view_tree_host.tick();
-    });
+    ViewTreeHost view_tree_host{root, view_pool};
+    main_loop.run();
   } catch (base::exception& e) {
-    LOG() << e.stack_trace().to_string(e.what());
+    LOG(GENERAL, ERROR) << e.stack_trace().to_string(e.what());
+  }
+
+  if (dump_loop_stats) {
+    std::ostringstream stats;
+    main_loop.dump_stats(stats);
+    LOG() << stats.str();
   }
 }
@@ -23,7 +23,7 @@ namespace cursedui::paint {
 
 namespace {
 
-void deintersect(std::list<gfx::Rect>& rs, std::list<gfx::Rect>& wrs) {
+void deintersect(std::pmr::list<gfx::Rect>& rs, std::pmr::list<gfx::Rect>& wrs) {
   for (auto wri = wrs.begin(); wri != wrs.end(); /* no auto incr */) {
     for (auto ri = rs.begin(); ri != rs.end(); /* no auto incr */) {
       auto& r = *ri;
@@ -38,7 +38,7 @@ void deintersect(std::list<gfx::Rect>& rs, std::list<gfx::Rect>& wrs) {
                          ((r.right <= wr.right) << 2) | ((r.bottom <= wr.bottom) << 3);
 
       gfx::Rect wr2 = wr;
-      LOG() << "----> bottom: " << bool(config & 0b1000)
+      LOG(PAINT, VERBOSE) << "----> bottom: " << bool(config & 0b1000)
             << ", right: " << bool(config & 0b0100) << ", top: " << bool(config & 0b0010)
             << ", left: " << bool(config & 0b0001);
       // bottom, right, top, left
@@ -133,31 +133,40 @@ void deintersect(std::list<gfx::Rect>& rs, std::list<gfx::Rect>& wrs) {
 
 }  // namespace
 
-Region::Region(const gfx::Rect& rect) noexcept : rects_{rect} {}
+Region::Region() noexcept = default;
+
+Region::Region(std::pmr::memory_resource* resource) noexcept : rects_(resource) {}
+
+Region::Region(const gfx::Rect& rect, std::pmr::memory_resource* resource) noexcept
+    : rects_({rect}, resource) {}
+
+Region::Region(const Region& other) noexcept
+    : rects_(other.rects_, other.rects_.get_allocator()) {}
 
 void Region::add(const gfx::Rect& rect) noexcept {
-  std::list<gfx::Rect> working_rects = {rect};
+  std::pmr::list<gfx::Rect> working_rects({rect}, rects_.get_allocator());
   deintersect(rects_, working_rects);
   for (auto& wr : working_rects)
     rects_.push_back(wr);
 }
 
 void Region::add(const Region& region) noexcept {
-  std::list<gfx::Rect> working_rects = region.rects_;
+  std::pmr::list<gfx::Rect> working_rects(region.rects_, rects_.get_allocator());
   deintersect(rects_, working_rects);
   for (auto& wr : working_rects)
     rects_.push_back(wr);
 }
 
 void Region::add(Region&& region) noexcept {
-  std::list<gfx::Rect> working_rects = std::move(region.rects_);
+  std::pmr::list<gfx::Rect> working_rects(std::move(region.rects_),
+                                          rects_.get_allocator());
   deintersect(rects_, working_rects);
   for (auto& wr : working_rects)
     rects_.push_back(wr);
 }
 
 Region Region::clip(const gfx::Rect& rect) const noexcept {
-  Region result;
+  Region result(resource());
   for (auto& clip : rects_) {
     auto clipped = do_clip(rect, clip);
     if (clipped.has_area())
@@ -167,7 +176,7 @@ Region Region::clip(const gfx::Rect& rect) const noexcept {
 }
 
 Region Region::clip(const Region& region) const noexcept {
-  Region result;
+  Region result(resource());
   for (auto& clip : rects_)
     for (auto& rect : region.rects_) {
       auto clipped = do_clip(rect, clip);
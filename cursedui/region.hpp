@@ -20,13 +20,23 @@
 #include "cursedui/dim.hpp"
 
 #include <list>
+#include <memory_resource>
 
 namespace cursedui::paint {
 
+// The rects are allocated from the given memory resource, e.g. the frame's arena. The
+// copies and the regions, made by clipping, use the same resource.
 class CURSEDUI_PUBLIC Region {
  public:
-  Region() noexcept = default;
-  explicit Region(const gfx::Rect& rect) noexcept;
+  Region() noexcept;
+  explicit Region(std::pmr::memory_resource* resource) noexcept;
+  explicit Region(
+      const gfx::Rect& rect,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
+  Region(const Region& other) noexcept;
+  Region(Region&& other) noexcept = default;
+  Region& operator=(const Region& other) = default;
+  Region& operator=(Region&& other) = default;
 
   void add(const gfx::Rect& rect) noexcept;
   void add(const Region& region) noexcept;
@@ -38,12 +48,16 @@ class CURSEDUI_PUBLIC Region {
 
   bool empty() const noexcept;
 
+  std::pmr::memory_resource* resource() const noexcept {
+    return rects_.get_allocator().resource();
+  }
+
   auto begin() const noexcept { return rects_.cbegin(); }
   auto end() const noexcept { return rects_.cend(); }
 
  private:
   // TODO: Maybe use quadro-trees?
-  std::list<gfx::Rect> rects_;
+  std::pmr::list<gfx::Rect> rects_;
 };
 
 }  // namespace cursedui::paint
@@ -0,0 +1,94 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cursedui/canvas.hpp"
+
+#include "avada/buffer.hpp"
+
+#include "gtest/gtest.h"
+
+#include <string_view>
+
+using namespace cursedui;
+using namespace cursedui::gfx;
+using namespace cursedui::paint;
+using avada::render::Buffer;
+using avada::render::SystemColor;
+
+namespace {
+
+const Pen kPen{SystemColor::DEFAULT, SystemColor::DEFAULT};
+
+}  // namespace
+
+TEST(CanvasTest, GlyphWidth) {
+  EXPECT_EQ(avada::render::glyph_width(L'a'), 1);
+  EXPECT_EQ(avada::render::glyph_width(L'◕'), 1);
+  EXPECT_EQ(avada::render::glyph_width(L'漢'), 2);
+  EXPECT_EQ(avada::render::glyph_width(L'한'), 2);
+  EXPECT_EQ(avada::render::glyph_width(L'😀'), 2);
+}
+
+TEST(CanvasTest, WideGlyphTakesTwoCells) {
+  Buffer buffer{1, 6};
+  Canvas canvas{buffer};
+
+  canvas.draw(std::wstring_view{L"a漢b"}, {0, 0}, kPen);
+
+  EXPECT_EQ(buffer(0, 0).data(), "a");
+  EXPECT_EQ(buffer(0, 1).width(), 2);
+  EXPECT_TRUE(buffer(0, 2).continuation());
+  EXPECT_EQ(buffer(0, 3).data(), "b");
+}
+
+TEST(CanvasTest, ClippedHalfGlyphIsBlanked) {
+  Buffer buffer{1, 6};
+  Canvas canvas{buffer};
+
+  {
+    auto clip = canvas.push_clip(Rect{0, 0, 2, 0});
+    canvas.draw(std::wstring_view{L"a漢漢"}, {0, 0}, kPen);
+  }
+  EXPECT_EQ(buffer(0, 1).width(), 2);
+  EXPECT_TRUE(buffer(0, 2).continuation());
+  EXPECT_EQ(buffer(0, 3).width(), 1);
+  EXPECT_TRUE(buffer(0, 3).data().empty());
+
+  {
+    auto clip = canvas.push_clip(Rect{2, 0, 5, 0});
+    canvas.draw(std::wstring_view{L"漢漢"}, {1, 0}, kPen);
+  }
+  // The left half of the first glyph is out of the clip.
+  EXPECT_EQ(buffer(0, 2).data(), " ");
+  EXPECT_EQ(buffer(0, 3).width(), 2);
+  EXPECT_TRUE(buffer(0, 4).continuation());
+}
+
+TEST(CanvasTest, OverwritingHalfGlyphBlanksTheOtherHalf) {
+  Buffer buffer{1, 4};
+  Canvas canvas{buffer};
+
+  canvas.draw(L'漢', {0, 0}, kPen);
+  canvas.draw(L'漢', {2, 0}, kPen);
+
+  canvas.draw('x', {1, 0}, kPen);
+  EXPECT_EQ(buffer(0, 0).data(), " ");
+  EXPECT_EQ(buffer(0, 1).data(), "x");
+
+  canvas.draw('y', {2, 0}, kPen);
+  EXPECT_EQ(buffer(0, 2).data(), "y");
+  EXPECT_EQ(buffer(0, 3).data(), " ");
+  EXPECT_FALSE(buffer(0, 3).continuation());
+}
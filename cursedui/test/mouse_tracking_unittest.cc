@@ -0,0 +1,84 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "avada/input.hpp"
+#include "cursedui/test/test_harness.hpp"
+#include "cursedui/views/frame_layout.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace cursedui;
+using namespace cursedui::gfx;
+using namespace cursedui::view;
+using avada::input::MouseEvent;
+
+namespace {
+
+class RecordingView : public test::ViewForTest {
+ public:
+  RecordingView() : ViewForTest({10, 10}) {}
+
+  std::vector<std::string> events;
+
+ protected:
+  void on_mouse_event(const MouseEvent& event) override {
+    events.push_back(event.to_string());
+  }
+};
+
+const auto kMove = MouseEvent{1, 1};
+const auto kClick = MouseEvent{
+    1, 1, MouseEvent::ButtonEvent{MouseEvent::Button::LEFT, MouseEvent::State::PRESSED}};
+
+MouseEvent make_drag() {
+  auto drag = MouseEvent{2, 2};
+  drag.held_button = MouseEvent::Button::LEFT;
+  return drag;
+}
+
+}  // namespace
+
+TEST(MouseTrackingTest, MotionIsNotDeliveredByDefault) {
+  auto fl = base::make_ref_ptr<FrameLayout>();
+  auto view = base::make_ref_ptr<RecordingView>();
+  fl->add_child(view);
+  fl->layout_as_root({0, 0, 10, 10});
+
+  fl->dispatch_mouse_event(kMove);
+  fl->dispatch_mouse_event(make_drag());
+  fl->dispatch_mouse_event(kClick);
+
+  EXPECT_EQ(view->events, (std::vector{kClick.to_string()}));
+}
+
+TEST(MouseTrackingTest, HoverAndDrag) {
+  auto fl = base::make_ref_ptr<FrameLayout>();
+  auto view = base::make_ref_ptr<RecordingView>();
+  fl->add_child(view);
+  fl->layout_as_root({0, 0, 10, 10});
+
+  view->set_mouse_tracking(MouseTracking::HOVER);
+  fl->dispatch_mouse_event(kMove);
+  fl->dispatch_mouse_event(make_drag());
+  EXPECT_EQ(view->events, (std::vector{kMove.to_string()}));
+
+  view->events.clear();
+  view->set_mouse_tracking(MouseTracking::DRAG);
+  fl->dispatch_mouse_event(kMove);
+  fl->dispatch_mouse_event(make_drag());
+  EXPECT_EQ(view->events, (std::vector{make_drag().to_string()}));
+}
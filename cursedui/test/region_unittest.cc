@@ -16,6 +16,7 @@
 #include "cursedui/region.hpp"
 
 #include "base/debug/debug.hpp"
+#include "base/monotonic_arena.hpp"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -213,3 +214,15 @@ TEST(RegionTest, LargeSequence) {
       Rect{2, 4, 6, 5},
   });
 }
+
+TEST(RegionTest, KeepsMemoryResource) {
+  base::MonotonicArena arena;
+  Region region{Rect{0, 0, 10, 10}, &arena};
+  region.add(Rect{5, 5, 15, 15});
+
+  const Region copy = region;
+  EXPECT_EQ(copy.resource(), &arena);
+  EXPECT_EQ(region.clip(Rect{0, 0, 3, 3}).resource(), &arena);
+  EXPECT_EQ(region.clip(copy).resource(), &arena);
+  EXPECT_EQ(all_rects_from(copy), all_rects_from(region));
+}
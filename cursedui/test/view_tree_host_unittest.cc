@@ -0,0 +1,113 @@
+/* Copyright 2020-2024 Fedor Ihnatkevich
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/run_loop.hpp"
+#include "cursedui/view_tree_host.hpp"
+#include "cursedui/views/button.hpp"
+#include "cursedui/views/frame_layout.hpp"
+#include "cursedui/views/text_view.hpp"
+
+#include "gtest/gtest.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string_view>
+
+using namespace cursedui;
+using namespace cursedui::view;
+
+namespace {
+
+// Runs the host on a pseudo terminal, which stands in for stdin and stdout.
+class ViewTreeHostTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    terminal_ = ::posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_NE(terminal_, -1);
+    ASSERT_EQ(::grantpt(terminal_), 0);
+    ASSERT_EQ(::unlockpt(terminal_), 0);
+    const int tty = ::open(::ptsname(terminal_), O_RDWR | O_NOCTTY);
+    ASSERT_NE(tty, -1);
+    winsize size{};
+    size.ws_row = 5;
+    size.ws_col = 20;
+    ASSERT_EQ(::ioctl(tty, TIOCSWINSZ, &size), 0);
+
+    saved_stdin_ = ::dup(STDIN_FILENO);
+    saved_stdout_ = ::dup(STDOUT_FILENO);
+    ::dup2(tty, STDIN_FILENO);
+    ::dup2(tty, STDOUT_FILENO);
+    ::close(tty);
+    ::setenv("TERM", "xterm-256color", /*overwrite=*/0);
+    base::RunLoop::set_main(&loop_);
+  }
+
+  void TearDown() override {
+    base::RunLoop::set_main(nullptr);
+    ::dup2(saved_stdin_, STDIN_FILENO);
+    ::dup2(saved_stdout_, STDOUT_FILENO);
+    ::close(saved_stdin_);
+    ::close(saved_stdout_);
+    ::close(terminal_);
+  }
+
+  // Types the `input` into the terminal and runs the loop until it's handled.
+  void type(std::string_view input) {
+    ASSERT_EQ(::write(terminal_, input.data(), input.size()),
+              static_cast<ssize_t>(input.size()));
+    auto exit = loop_.post_delayed([this]() { loop_.exit_when_idle(); },
+                                   std::chrono::milliseconds{50});
+    loop_.run();
+  }
+
+  base::RunLoop loop_;
+  int terminal_ = -1;
+  int saved_stdin_ = -1;
+  int saved_stdout_ = -1;
+};
+
+constexpr std::string_view kPaste = "\x1B[200~pasted\rtext\x1B[201~";
+
+}  // namespace
+
+TEST_F(ViewTreeHostTest, PasteGoesToFocusedView) {
+  auto root = base::make_ref_ptr<FrameLayout>();
+  auto text_view = base::make_ref_ptr<TextView>();
+  text_view->set_editable(true);
+  root->add_child(text_view);
+  ViewTreeHost host{root};
+  host.set_focused_view(text_view);
+
+  type(kPaste);
+
+  EXPECT_EQ(text_view->get_text(), "pasted\ntext");
+}
+
+TEST_F(ViewTreeHostTest, PasteDoesNotChangeFocusedButton) {
+  auto root = base::make_ref_ptr<FrameLayout>();
+  auto button = base::make_ref_ptr<Button>();
+  button->set_text("OK");
+  root->add_child(button);
+  ViewTreeHost host{root};
+  host.set_focused_view(button);
+
+  type(kPaste);
+
+  EXPECT_EQ(button->get_text(), "OK");
+}
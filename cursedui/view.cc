@@ -28,7 +28,7 @@ namespace cursedui::view {
 void View::measure(MeasureSpec width_spec, MeasureSpec height_spec) {
   if (measured_size_ && !needs_layout() && last_width_spec_ == width_spec &&
       last_height_spec_ == height_spec) {
-    LOG() << "Measure optimized out for '" << debug_name() << "'";
+    LOG(LAYOUT, VERBOSE) << "Measure optimized out for '" << debug_name() << "'";
     return;
   }
 
@@ -92,7 +92,7 @@ void View::draw(paint::Canvas& canvas) {
 
   auto culled = canvas.push_clip(outer_bounds());
   if (culled) {
-    LOG() << "view '" << debug_name() << "' culled";
+    LOG(PAINT, VERBOSE) << "view '" << debug_name() << "' culled";
     return;
   }
 
@@ -101,6 +101,9 @@ void View::draw(paint::Canvas& canvas) {
 
 void View::dispatch_mouse_event(const avada::input::MouseEvent& event) {
   using namespace avada::input;
+  if (event.motion() && !tracks(event))
+    return;
+
   std::visit(base::overloaded{
                  [this](MouseEvent::ButtonEvent be) {
                    if (be.code == MouseEvent::Button::LEFT &&
@@ -116,6 +119,8 @@ void View::dispatch_mouse_event(const avada::input::MouseEvent& event) {
 
 void View::on_key_event(const avada::input::KeyboardEvent&) {}
 
+void View::on_paste(std::string_view) {}
+
 void View::on_mouse_event(const avada::input::MouseEvent&) {}
 
 bool View::focused() const noexcept {
@@ -151,7 +156,9 @@ View::View() noexcept
       background_(nullptr),
       parent_(nullptr),
       needs_layout_(NeedsLayout::SIZE),
-      needs_paint_(true) {
+      needs_paint_(true),
+      render_priority_(0),
+      mouse_tracking_(MouseTracking::NONE) {
   border_.owned_by(this);
 }
 
@@ -202,6 +209,13 @@ void View::set_tree_host(base::nullable<ViewTreeHost> tree_host) {
     unfocus();
   }
 
+  if (mouse_tracking_) {
+    if (view_tree_host_)
+      view_tree_host_->remove_mouse_tracking_view();
+    if (tree_host)
+      tree_host.get()->add_mouse_tracking_view();
+  }
+
   view_tree_host_ = tree_host.get_nullable();
   on_tree_host_set();
 
@@ -210,6 +224,24 @@ void View::set_tree_host(base::nullable<ViewTreeHost> tree_host) {
   mark_needs_paint();
 }
 
+void View::set_mouse_tracking(base::EnumFlags<MouseTracking> tracking) noexcept {
+  if (mouse_tracking_ == tracking)
+    return;
+
+  if (view_tree_host_) {
+    if (!mouse_tracking_)
+      view_tree_host_->add_mouse_tracking_view();
+    else if (!tracking)
+      view_tree_host_->remove_mouse_tracking_view();
+  }
+  mouse_tracking_ = tracking;
+}
+
+bool View::tracks(const avada::input::MouseEvent& motion) const noexcept {
+  return mouse_tracking_.has(motion.held_button ? MouseTracking::DRAG
+                                                : MouseTracking::HOVER);
+}
+
 base::nullable<ViewTreeHost> View::tree_host() noexcept {
   return view_tree_host_;
 }
@@ -257,7 +289,7 @@ void View::dispatch_layout(bool changed) {
     // Mark view as needs paint automatically.
     mark_needs_paint();
   } else {
-    LOG() << "view '" << debug_name() << "' layout skipped";
+    LOG(LAYOUT, VERBOSE) << "view '" << debug_name() << "' layout skipped";
   }
 }
 
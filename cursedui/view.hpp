@@ -26,6 +26,7 @@
 #include "cursedui/config.hpp"
 
 #include <memory>
+#include <string_view>
 #include <utility>
 
 namespace avada::input {
@@ -68,6 +69,9 @@ class CURSEDUI_PUBLIC View : public base::WeakReferenced {
 
   virtual void dispatch_mouse_event(const avada::input::MouseEvent& event);
   virtual void on_key_event(const avada::input::KeyboardEvent& event);
+  // Receives the whole pasted text at once, so it can be taken in with a single
+  // layout pass.
+  virtual void on_paste(std::string_view text);
 
   virtual bool focusable() const noexcept { return false; }
   bool focused() const noexcept;
@@ -102,6 +106,20 @@ class CURSEDUI_PUBLIC View : public base::WeakReferenced {
   void mark_needs_paint() noexcept { needs_paint_ = true; }
   bool needs_paint() const noexcept { return needs_paint_; }
 
+  // Views with higher render priority are rendered first, when the rendering is limited
+  // by a byte budget (see `ViewTreeHost::set_render_budget`). A screen cell takes the
+  // highest priority among the views covering it, so a child is rendered with at least
+  // the non-default priority of its ancestors, and may only raise it.
+  void set_render_priority(int priority) noexcept { render_priority_ = priority; }
+  GETTER int render_priority() const noexcept { return render_priority_; }
+
+  // Mouse motion is only delivered to the views, which asked for it.
+  void set_mouse_tracking(base::EnumFlags<MouseTracking> tracking) noexcept;
+  GETTER base::EnumFlags<MouseTracking> mouse_tracking() const noexcept {
+    return mouse_tracking_;
+  }
+  GETTER bool tracks(const avada::input::MouseEvent& motion) const noexcept;
+
   virtual void visit_down(const ViewTreeVisitor& visitor);
   void visit_up(const ViewTreeVisitor& visitor);
 
@@ -140,6 +158,8 @@ class CURSEDUI_PUBLIC View : public base::WeakReferenced {
 
   base::EnumFlags<NeedsLayout> needs_layout_;
   bool needs_paint_;
+  int render_priority_;
+  base::EnumFlags<MouseTracking> mouse_tracking_;
   std::optional<MeasureSpec> last_width_spec_, last_height_spec_;
 
   std::string debug_name_;
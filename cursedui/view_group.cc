@@ -95,7 +95,7 @@ void ViewGroup::remove_child_internal(children_container_t::iterator child) noex
 }
 
 void ViewGroup::dispatch_mouse_event(const avada::input::MouseEvent& event) {
-  if (intercept_mouse_event(event)) {
+  if ((!event.motion() || tracks(event)) && intercept_mouse_event(event)) {
     on_mouse_event(event);
     return;
   }
@@ -72,6 +72,21 @@ enum class CURSEDUI_PUBLIC NeedsLayout : uint8_t {
   // clang-format on
 };
 
+enum class CURSEDUI_PUBLIC MouseTracking : uint8_t {
+  // clang-format off
+
+  // No mouse motion is delivered.
+  NONE  = 0b00,
+
+  // Mouse motion with no button held.
+  HOVER = 0b01,
+
+  // Mouse motion with a button held.
+  DRAG  = 0b10,
+
+  // clang-format on
+};
+
 CURSEDUI_PUBLIC
 MeasureSpec make_measure_spec(LayoutSpec layout, MeasureSpec parent_measure) noexcept;
 
@@ -15,6 +15,7 @@
 
 #include "cursedui/view_tree_host.hpp"
 
+#include "base/debug/tracing.hpp"
 #include "base/run_loop.hpp"
 #include "base/util.hpp"
 #include "base/weak_ref.hpp"
@@ -22,6 +23,8 @@
 #include "cursedui/view.hpp"
 #include "cursedui/view_group.hpp"
 
+#include <algorithm>
+#include <memory_resource>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -45,15 +48,30 @@ class ViewTreeVisitor : public view::ViewTreeVisitor {
 
 }  // namespace
 
-ViewTreeHost::ViewTreeHost(base::ref_ptr<view::View> root)
-    : root_(std::move(root)),
+ViewTreeHost::ViewTreeHost(base::ref_ptr<view::View> root,
+                           base::ref_ptr<base::ObjectPool> view_pool)
+    : view_pool_(std::move(view_pool)),
+      root_(std::move(root)),
       root_size_{avada_.get_columns(), avada_.get_rows()},
-      need_root_resize_{true} {
+      need_root_resize_{true},
+      render_budget_{0},
+      render_pending_{false},
+      mouse_tracking_views_{0} {
   root_->set_tree_host(this);
 
+  auto& loop = base::RunLoop::main();
+  avada_.watch(loop, [this]() { handle_events(); });
+  // Whatever has changed while handling tasks is rendered once the loop runs out of
+  // them.
+  loop.set_before_sleep([this]() { frame(); });
+
   view_tree_routine();
 }
 
+ViewTreeHost::~ViewTreeHost() noexcept {
+  base::RunLoop::main().set_before_sleep(nullptr);
+}
+
 void ViewTreeHost::set_focused_view(base::ref_ptr<view::View> focused_view) noexcept {
   if (focused_view_ == focused_view)
     return;
@@ -63,26 +81,21 @@ void ViewTreeHost::set_focused_view(base::ref_ptr<view::View> focused_view) noex
   } else {
     ASSERT(focused_view->tree_host() == this);
     focused_view_ = base::weak_ref(focused_view);
-    LOG() << "ViewTreeHost: view '" << focused_view->debug_name() << "' focused.";
+    LOG(INPUT, INFO) << "ViewTreeHost: view '" << focused_view->debug_name()
+                     << "' focused.";
   }
 }
 
 base::ref_ptr<view::View> ViewTreeHost::focused_view() const noexcept {
+  // Not a `base::Handle`: the view stays registered while its destructors run, and a
+  // new reference to it then would delete it twice. `lock()` fails once the ref count
+  // has dropped to zero.
   return focused_view_.lock();
 }
 
-void ViewTreeHost::work_routine() {
+void ViewTreeHost::handle_events() {
   using namespace avada::input;
 
-  avada::input::Event event;
-
-  try {
-    event = avada_.poll_event(1ms);
-  } catch (avada::input::unparsed_exception& e) {
-    LOG() << "Unparsed input! See: " << e.what();
-    event = ServiceEvent::IDLE;
-  }
-
   const auto visitor = base::overloaded{
       [this](const ResizeEvent& re) {
         gfx::Size new_size{re.columns, re.rows};
@@ -92,6 +105,14 @@ void ViewTreeHost::work_routine() {
         need_root_resize_ = true;
       },
       [this](const KeyboardEvent& key) {
+        if (key.released()) {
+          // Only the focused view may be interested in releases.
+          if (auto view = focused_view()) {
+            view->on_key_event(key);
+          }
+          return;
+        }
+
         if (key == KeyboardKey::TAB) {
           // TODO: focused view switching logic
           return;
@@ -106,40 +127,104 @@ void ViewTreeHost::work_routine() {
           return;
         }
 
-        if (auto view = focused_view_.lock()) {
+        if (auto view = focused_view()) {
           view->on_key_event(key);
         }
       },
-      [this](const MouseEvent& mouse) { root_->dispatch_mouse_event(mouse); },
+      [this](const MouseEvent& mouse) {
+        // Don't even traverse the tree with motion, if no view tracks it.
+        if (mouse.motion() && mouse_tracking_views_ == 0)
+          return;
+        root_->dispatch_mouse_event(mouse);
+      },
+      [this](const PasteEvent& paste) {
+        if (auto view = focused_view()) {
+          view->on_paste(paste.text);
+        }
+      },
       [](ServiceEvent se) {
         ASSERT(se == ServiceEvent::IDLE);
         // nothing else here
       }};
-  std::visit(visitor, event);
+  // All the events read at once are handled before the single layout/paint pass.
+  while (auto event = avada_.next_event()) {
+    std::visit(visitor, *event);
+  }
+}
 
-  if (base::RunLoop::current().exit_requested())
+void ViewTreeHost::frame() {
+  auto& loop = base::RunLoop::main();
+  if (loop.exit_requested())
     return;
 
   animation_host_.tick();
 
   view_tree_routine();
+
+  // Keep the frames coming while there is something to show.
+  if (next_frame_)
+    return;
+  base::RunLoop::duration_t delay;
+  if (render_pending_) {
+    delay = 0ms;
+  } else if (animation_host_.running()) {
+    delay = animation::Animation::interval_v;
+  } else {
+    loop.set_frame_deadline(std::nullopt);
+    return;
+  }
+  // The idle tasks run until then.
+  loop.set_frame_deadline(base::RunLoop::clock_t::now() + delay);
+  next_frame_ = loop.post_delayed(
+      [this]() {
+        next_frame_ = nullptr;
+        frame();
+      },
+      delay, base::RunLoop::Priority::FRAME);
 }
 
 void ViewTreeHost::view_tree_routine() {
-  paint::Canvas canvas(avada_.render_buffer());
-  paint::Region paint_region;
+  base::debug::ScopedTrace trace{"ViewTreeHost::view_tree_routine"};
+  frame_arena_.reset();
+  paint::Canvas canvas(avada_.render_buffer(), &frame_arena_);
+  paint::Region paint_region(&frame_arena_);
   layout_tree(paint_region);
-  if (paint_tree(paint_region, canvas)) {
-    avada_.render();
+  // Render if painted something or if there is damage left from the previous frame.
+  if (paint_tree(paint_region, canvas) || render_pending_) {
+    render_pending_ = !avada_.render(render_options());
   }
 }
 
-void ViewTreeHost::tick() {
-  // view_tree_routine();
-  work_routine();
+avada::render::RenderOptions ViewTreeHost::render_options() {
+  avada::render::RenderOptions options;
+  options.byte_budget = render_budget_;
+  if (render_budget_ == 0) {
+    // Priorities make no difference if everything is rendered at once.
+    return options;
+  }
+
+  const auto add_area = [&options](const gfx::Rect& bounds, int priority) {
+    options.priorities.push_back(avada::render::RenderPriorityArea{
+        bounds.top, bounds.left, bounds.bottom, bounds.right, priority});
+  };
+
+  root_->visit_down(ViewTreeVisitor{
+      [&add_area](view::View* view) {
+        if (view->render_priority() != 0)
+          add_area(view->outer_bounds(), view->render_priority());
+        return view::VisitResult::CONTINUE_VISIT;
+      },
+  });
+
+  if (auto view = focused_view()) {
+    add_area(view->outer_bounds(),
+             std::max(view->render_priority(), kFocusedViewRenderPriority));
+  }
+  return options;
 }
 
 void ViewTreeHost::layout_tree(paint::Region& repaint_region) {
+  base::debug::ScopedTrace trace{"ViewTreeHost::layout_tree"};
   if (need_root_resize_) {
     auto bounds = gfx::rect_from({}, root_size_);
     // Mark root as needing size layout to keep internal invariants intact.
@@ -150,9 +235,9 @@ void ViewTreeHost::layout_tree(paint::Region& repaint_region) {
     return;
   }
 
-  std::unordered_map<view::View*, gfx::Rect> old_bounds;
+  std::pmr::unordered_map<view::View*, gfx::Rect> old_bounds(&frame_arena_);
 
-  std::vector<view::View*> roots_needing_layout;
+  std::pmr::vector<view::View*> roots_needing_layout(&frame_arena_);
 
   const auto scan_visitor = ViewTreeVisitor{
       [&roots_needing_layout](view::View* view) {
@@ -193,7 +278,7 @@ void ViewTreeHost::layout_tree(paint::Region& repaint_region) {
 
     // Step IV: Perform actual layout on every final detected root.
     for (auto* view : roots_needing_layout) {
-      LOG() << "ViewTreeHost layout: layouting " << view->debug_name();
+      LOG(LAYOUT, VERBOSE) << "ViewTreeHost layout: layouting " << view->debug_name();
       view->relayout();
     }
   } while (!roots_needing_layout.empty());
@@ -204,7 +289,8 @@ void ViewTreeHost::layout_tree(paint::Region& repaint_region) {
 }
 
 bool ViewTreeHost::paint_tree(paint::Region& paint_region, paint::Canvas& canvas) {
-  std::vector<view::View*> roots_to_paint;
+  base::debug::ScopedTrace trace{"ViewTreeHost::paint_tree"};
+  std::pmr::vector<view::View*> roots_to_paint(&frame_arena_);
   root_->visit_down(ViewTreeVisitor{
       [&roots_to_paint](view::View* view) {
         if (view->needs_paint()) {
@@ -18,11 +18,16 @@
 #include "avada/avada.hpp"
 #include "avada/input.hpp"
 #include "base/macro.hpp"
+#include "base/monotonic_arena.hpp"
+#include "base/object_pool.hpp"
+#include "base/run_loop.hpp"
+#include "base/unique_function.hpp"
 #include "cursedui/animation/animation_host.hpp"
 #include "cursedui/view.hpp"
 
 #include "cursedui/config.hpp"
 
+#include <cstddef>
 #include <functional>
 
 namespace cursedui::paint {
@@ -35,9 +40,21 @@ namespace cursedui {
 class CURSEDUI_PUBLIC ViewTreeHost {
  public:
   // returns `true` if the key is handled and should not be passed down
-  using keyboard_handler_t = std::function<bool(const avada::input::KeyboardEvent&)>;
-
-  ViewTreeHost(base::ref_ptr<view::View> root);
+  using keyboard_handler_t =
+      base::UniqueFunction<bool(const avada::input::KeyboardEvent&)>;
+
+  // Runs on the `base::RunLoop::main()`: handles input as it comes and renders
+  // whatever has changed, once the loop runs out of tasks.
+  // The views, made with `make_view`, are allocated from `view_pool`, if any, so the
+  // tree stays compact in memory. The root should be allocated from it as well.
+  ViewTreeHost(base::ref_ptr<view::View> root,
+               base::ref_ptr<base::ObjectPool> view_pool = nullptr);
+  ~ViewTreeHost() noexcept;
+
+  template <class V, class... Args>
+  base::ref_ptr<V> make_view(Args&&... args) /* may throw */ {
+    return base::make_ref_ptr_in<V>(view_pool_.get(), std::forward<Args>(args)...);
+  }
 
   void set_focused_view(base::ref_ptr<view::View> focused_view) noexcept;
   GETTER base::ref_ptr<view::View> focused_view() const noexcept;
@@ -45,18 +62,33 @@ class CURSEDUI_PUBLIC ViewTreeHost {
   GETTER animation::AnimationHost& animation_host() noexcept { return animation_host_; }
 
   void set_keyboard_handler(keyboard_handler_t handler) noexcept {
-    keyboard_handler_ = handler;
+    keyboard_handler_ = std::move(handler);
   }
 
-  void tick();
+  // Limits the amount of bytes written to the terminal per frame, `0` means unlimited.
+  // The damage is rendered in order of views' render priorities, the focused view goes
+  // first. Whatever doesn't fit into the budget is rendered on the following frames.
+  void set_render_budget(std::size_t bytes) noexcept { render_budget_ = bytes; }
+  GETTER std::size_t render_budget() const noexcept { return render_budget_; }
+
+  static constexpr int kFocusedViewRenderPriority = 100;
 
  private:
+  friend class view::View;
+
+  // Counts views, which track mouse motion, see `View::set_mouse_tracking`.
+  void add_mouse_tracking_view() noexcept { ++mouse_tracking_views_; }
+  void remove_mouse_tracking_view() noexcept { --mouse_tracking_views_; }
+
   void layout_tree(paint::Region& repaint_region);
   bool paint_tree(paint::Region& paint_region, paint::Canvas& canvas);
 
-  void work_routine();
+  void handle_events();
+  void frame();
   void view_tree_routine();
 
+  avada::render::RenderOptions render_options();
+
  private:
   avada::Context avada_;
 
@@ -64,11 +96,18 @@ class CURSEDUI_PUBLIC ViewTreeHost {
   animation::AnimationHost animation_host_;
   
   // Order is important
+  const base::ref_ptr<base::ObjectPool> view_pool_;
   const base::ref_ptr<view::View> root_;
 
   keyboard_handler_t keyboard_handler_;
   gfx::Size root_size_;
   bool need_root_resize_;
+  std::size_t render_budget_;
+  bool render_pending_;
+  int mouse_tracking_views_;
+  // The transient layout and paint data of the frame, reset before each frame.
+  base::MonotonicArena frame_arena_;
+  base::ref_ptr<base::RunLoop::DelayedTask> next_frame_;
   DISABLE_COPY_AND_ASSIGN(ViewTreeHost);
 };
 
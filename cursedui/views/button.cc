@@ -38,7 +38,7 @@ void Button::on_mouse_event(const MouseEvent& event) {
 }
 
 void Button::on_key_event(const KeyboardEvent& event) {
-  if (!on_click_) 
+  if (!on_click_ || event.released())
     return;
 
   auto is_click = std::visit(base::overloaded {
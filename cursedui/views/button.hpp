@@ -1,24 +1,23 @@
 #pragma once
 
+#include "base/unique_function.hpp"
 #include "cursedui/view.hpp"
 #include "cursedui/views/text_view.hpp"
 
-#include <functional>
-
 namespace cursedui::view {
 
 class CURSEDUI_PUBLIC Button : public TextView {
 public:
-  using on_click_t = std::function<void()>;
+  using on_click_t = base::UniqueFunction<void()>;
 
   Button() noexcept;
   ~Button() noexcept override;
 
   void set_on_click(on_click_t callback) noexcept {
-    on_click_ = callback;
+    on_click_ = std::move(callback);
   }
 
-  GETTER on_click_t on_click() const noexcept { return on_click_; }
+  GETTER const on_click_t& on_click() const noexcept { return on_click_; }
 
   bool focusable() const noexcept override { return true; }
 
@@ -29,6 +28,9 @@ protected:
 private:
   using TextView::set_multiline;
   using TextView::multiline;
+  // A label, not a text input, even though it's focusable.
+  using TextView::set_editable;
+  using TextView::editable;
 
   on_click_t on_click_;
 };
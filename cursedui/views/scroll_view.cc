@@ -16,7 +16,7 @@
 #include "cursedui/views/scroll_view.hpp"
 
 #include "avada/input.hpp"
-#include "base/run_loop.hpp"
+#include "base/coroutine.hpp"
 #include "base/util.hpp"
 #include "cursedui/animation/animation_host.hpp"
 #include "cursedui/animation/animations.hpp"
@@ -108,15 +108,9 @@ bool ScrollView::intercept_mouse_event(const avada::input::MouseEvent& event) {
               scroll_bar_opacity_, 1.0f, 200ms);
           animation::start_view_animation(this, scroll_fade_in_.get());
         }
-        hide_scroll_bar_ = base::RunLoop::current().post_delayed([this]() {
-          scroll_fade_in_ = nullptr;
-          if (!scroll_fade_out_) {
-            scroll_fade_out_ = base::make_ref_ptr<animation::DoubleAnimation>(
-                scroll_bar_opacity_, 0.0f, 200ms);
-            animation::start_view_animation(this, scroll_fade_out_.get());
-          }
-          hide_scroll_bar_ = nullptr;
-        }, 1000ms);
+        // Restarts the countdown, if it's already running.
+        hide_scroll_bar_ = hide_scroll_bar_later();
+        hide_scroll_bar_.start();
         return true;
       },
       [](auto) -> bool { return false; },
@@ -124,6 +118,17 @@ bool ScrollView::intercept_mouse_event(const avada::input::MouseEvent& event) {
   return std::visit(visitor, event.data);
 }
 
+base::Task<> ScrollView::hide_scroll_bar_later() {
+  co_await base::delay(1000ms);
+
+  scroll_fade_in_ = nullptr;
+  if (!scroll_fade_out_) {
+    scroll_fade_out_ = base::make_ref_ptr<animation::DoubleAnimation>(
+        scroll_bar_opacity_, 0.0f, 200ms);
+    animation::start_view_animation(this, scroll_fade_out_.get());
+  }
+}
+
 void ScrollView::on_mouse_event(const avada::input::MouseEvent&) {}
 
 void ScrollView::on_draw(paint::Canvas& canvas) {
@@ -16,7 +16,7 @@
 #pragma once
 
 #include "base/enum_flags.hpp"
-#include "base/run_loop.hpp"
+#include "base/coroutine.hpp"
 #include "cursedui/animation/animations.hpp"
 #include "cursedui/views/frame_layout.hpp"
 
@@ -51,10 +51,11 @@ class CURSEDUI_PUBLIC ScrollView : public FrameLayout {
 
  private:
   void scroll_by(gfx::dim_t dx, gfx::dim_t dy) noexcept;
+  base::Task<> hide_scroll_bar_later();
 
  private:
   base::ref_ptr<animation::Animation> scroll_fade_in_, scroll_fade_out_;
-  base::ref_ptr<base::RunLoop::DelayedTask> hide_scroll_bar_;
+  base::Task<> hide_scroll_bar_;
   animation::AnimationValue<double> scroll_bar_opacity_;
 
   base::EnumFlags<ScrollDirection> direction_;
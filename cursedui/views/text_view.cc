@@ -191,6 +191,7 @@ void TextView::on_focus_changed(bool focused) {
 TextView::TextView() noexcept
     : gravity_(gfx::Gravity::CENTER),
       multiline_(false),
+      editable_(false),
       text_color_(avada::render::SystemColor::DEFAULT) {}
 
 void TextView::set_text(std::string str) noexcept {
@@ -216,6 +217,23 @@ void TextView::append_text(std::string_view str) noexcept {
   mark_needs_paint();
 }
 
+void TextView::on_paste(std::string_view text) {
+  if (!editable_)
+    return;
+
+  // Terminals send line breaks in the pasted text as carriage returns.
+  std::string normalized;
+  normalized.reserve(text.size());
+  std::size_t start = 0;
+  for (auto cr = text.find('\r'); cr != std::string_view::npos;
+       cr = text.find('\r', start)) {
+    normalized.append(text.substr(start, cr - start)).push_back('\n');
+    start = cr + (text.substr(cr, 2) == "\r\n" ? 2 : 1);
+  }
+  normalized.append(text.substr(start));
+  append_text(normalized);
+}
+
 void TextView::set_gravity(base::EnumFlags<gfx::Gravity> gravity) noexcept {
   if (gravity_ == gravity)
     return;
@@ -44,7 +44,15 @@ class CURSEDUI_PUBLIC TextView : public View {
   void set_text_color(avada::render::Color color) noexcept;
   GETTER avada::render::Color text_color() const noexcept { return text_color_; }
 
-  bool focusable() const noexcept override { return false; }
+  // Editable text views are focusable and take the pasted text in. Typing isn't
+  // handled yet.
+  void set_editable(bool editable) noexcept { editable_ = editable; }
+  GETTER bool editable() const noexcept { return editable_; }
+
+  bool focusable() const noexcept override { return editable_; }
+
+  // Appends the pasted text, if editable.
+  void on_paste(std::string_view text) override;
 
  protected:
   gfx::Size on_measure(MeasureSpec width_spec, MeasureSpec height_spec) override;
@@ -62,6 +70,7 @@ class CURSEDUI_PUBLIC TextView : public View {
   std::string text_;
   base::EnumFlags<gfx::Gravity> gravity_;
   bool multiline_;
+  bool editable_;
   avada::render::Color text_color_;
 
   // layout scoped attributes: